@@ -1,7 +1,105 @@
 ﻿#ifndef AVLTree_
 #define AVLTree_
 
-template <typename T>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <vector>
+
+// Стратегии выделения памяти под узлы дерева.
+// Обязательные методы: allocate, deallocate и release - освобождение всех узлов сразу,
+// если bulk_release == true.
+
+// Каждый узел выделяется отдельно через operator new.
+class HeapPool
+{
+public:
+	static constexpr bool bulk_release = false;
+
+	void* allocate (size_t size)
+	{
+		return ::operator new (size);
+	}
+	void deallocate (void* p, size_t)
+	{
+		::operator delete (p);
+	}
+	void release ()
+	{}
+};
+
+// Узлы нарезаются из крупных блоков (slab), освобождённые узлы
+// попадают в список свободных и используются повторно.
+class SlabPool
+{
+	struct FreeNode
+	{
+		FreeNode* next_;
+	};
+
+	std::vector<char*> slabs_;
+	FreeNode* free_; // список освобождённых узлов.
+	char* current_; // неразмеченная часть последнего блока.
+	size_t left_; // количество узлов в неразмеченной части.
+
+	static constexpr size_t SlabNodes = 256;
+
+public:
+	static constexpr bool bulk_release = true;
+
+	SlabPool () : free_ (nullptr), current_ (nullptr), left_ (0)
+	{}
+	SlabPool (const SlabPool&) = delete;
+	SlabPool& operator=(const SlabPool&) = delete;
+
+	void* allocate (size_t size)
+	{
+		if (free_ != nullptr)
+		{
+			FreeNode* result = free_;
+			free_ = free_->next_;
+			return result;
+		}
+
+		if (left_ == 0)
+		{
+			current_ = static_cast<char*> (::operator new (size * SlabNodes));
+			slabs_.push_back (current_);
+			left_ = SlabNodes;
+		}
+
+		void* result = current_;
+		current_ += size;
+		--left_;
+
+		return result;
+	}
+	void deallocate (void* p, size_t)
+	{
+		FreeNode* node = static_cast<FreeNode*> (p);
+		node->next_ = free_;
+		free_ = node;
+	}
+	void release ()
+	{
+		for (char* slab : slabs_)
+		{
+			::operator delete (slab);
+		}
+
+		slabs_.clear ();
+		free_ = nullptr;
+		current_ = nullptr;
+		left_ = 0;
+	}
+
+	~SlabPool ()
+	{
+		release ();
+	}
+};
+
+template <typename T, typename Pool = SlabPool>
 class AVLTree
 {
 	struct Node
@@ -14,14 +112,6 @@ class AVLTree
 
 		Node (const T& X) : left_ (nullptr), right_ (nullptr), parent_ (nullptr), data_ (X), balance_ (0) {}
 
-		size_t height () const
-		{
-			size_t L = (left_ == nullptr) ? 0 : left_->height ();
-			size_t R = (right_ == nullptr) ? 0 : right_->height ();
-
-			return (L < R) ? R + 1 : L + 1;
-		}
-
 		Node* minimum ()
 		{
 			Node* now = this;
@@ -81,16 +171,21 @@ class AVLTree
 
 			return parent;
 		}
-
-		~Node ()
-		{
-			delete left_;
-			delete right_;
-		}
 	};
 
 	Node* root_; // корень дерева.
 	size_t count_; // количество элементов в дереве.
+	Pool pool_;
+
+	Node* create (const T& x)
+	{
+		return new (pool_.allocate (sizeof (Node))) Node (x);
+	}
+	void destroy (Node* node)
+	{
+		node->~Node ();
+		pool_.deallocate (node, sizeof (Node));
+	}
 
 	// функции поворотов для балансировки.
 	Node* rightRotate (Node*);
@@ -100,14 +195,24 @@ class AVLTree
 
 public:
 	AVLTree () : root_ (nullptr), count_ (0) {}
+	AVLTree (const AVLTree&) = delete;
+	AVLTree& operator=(const AVLTree&) = delete;
 
 	size_t size () const
 	{
 		return count_;
 	}
+
+	// Спуск по более высокому поддереву, баланс узла равен h(right) - h(left).
 	size_t height () const
 	{
-		return root_->height ();
+		size_t result = 0;
+		for (Node* now = root_; now != nullptr; ++result)
+		{
+			now = (now->balance_ > 0) ? now->right_ : now->left_;
+		}
+
+		return result;
 	}
 
 	class iterator
@@ -245,12 +350,7 @@ public:
 	iterator find (const T&) const;
 	void erase (const iterator&);
 
-	void clear ()
-	{
-		delete root_;
-		root_ = nullptr;
-		count_ = 0;
-	}
+	void clear ();
 
 	void empty ()
 	{
@@ -264,13 +364,58 @@ public:
 	}
 };
 
-template <typename T>
-void AVLTree<T>::insert (const T& x)
+template <typename T, typename Pool>
+void AVLTree<T, Pool>::clear ()
+{
+	if constexpr (std::is_trivially_destructible<T>::value && Pool::bulk_release)
+	{
+		pool_.release ();
+		root_ = nullptr;
+		count_ = 0;
+		return;
+	}
+
+	// Обход без рекурсии: удаляем листья, поднимаясь по parent_.
+	Node* now = root_;
+	while (now != nullptr)
+	{
+		if (now->left_ != nullptr)
+		{
+			now = now->left_;
+		} else if (now->right_ != nullptr)
+		{
+			now = now->right_;
+		} else
+		{
+			Node* parent = now->parent_;
+			if (parent != nullptr)
+			{
+				if (parent->left_ == now)
+				{
+					parent->left_ = nullptr;
+				} else
+				{
+					parent->right_ = nullptr;
+				}
+			}
+
+			destroy (now);
+			now = parent;
+		}
+	}
+
+	pool_.release ();
+	root_ = nullptr;
+	count_ = 0;
+}
+
+template <typename T, typename Pool>
+void AVLTree<T, Pool>::insert (const T& x)
 {
 	++count_;
 	if (root_ == nullptr)
 	{
-		root_ = new Node (x);
+		root_ = create (x);
 		return;
 	}
 
@@ -290,7 +435,7 @@ void AVLTree<T>::insert (const T& x)
 
 	} while (now != nullptr);
 
-	now = new Node (x);
+	now = create (x);
 	now->parent_ = parent;
 
 	if (x < parent->data_)
@@ -337,8 +482,8 @@ void AVLTree<T>::insert (const T& x)
 	} while (now != root_ && now->balance_ != 0);
 }
 
-template<typename T>
-typename AVLTree<T>::iterator AVLTree<T>::find (const T& x) const
+template <typename T, typename Pool>
+typename AVLTree<T, Pool>::iterator AVLTree<T, Pool>::find (const T& x) const
 {
 	Node* now = root_;
 	while (now != nullptr)
@@ -360,8 +505,8 @@ typename AVLTree<T>::iterator AVLTree<T>::find (const T& x) const
 	return iterator (now);
 }
 
-template <typename T>
-void AVLTree<T>::erase (typename AVLTree<T>::iterator const& pos)
+template <typename T, typename Pool>
+void AVLTree<T, Pool>::erase (typename AVLTree<T, Pool>::iterator const& pos)
 {
 	Node* toDelete = pos.current_;
 	if (toDelete == nullptr)
@@ -444,9 +589,7 @@ void AVLTree<T>::erase (typename AVLTree<T>::iterator const& pos)
 		alt->parent_ = toDelete->parent_;
 	}
 
-	toDelete->left_ = nullptr;
-	toDelete->right_ = nullptr;
-	delete toDelete;
+	destroy (toDelete);
 
 	while (notBalanced != nullptr)
 	{
@@ -492,8 +635,8 @@ void AVLTree<T>::erase (typename AVLTree<T>::iterator const& pos)
 	}
 }
 
-template <typename T>
-typename AVLTree<T>::Node* AVLTree<T>::leftRotate (typename AVLTree<T>::Node* a)
+template <typename T, typename Pool>
+typename AVLTree<T, Pool>::Node* AVLTree<T, Pool>::leftRotate (typename AVLTree<T, Pool>::Node* a)
 {
 	if (a->balance_ != 2)
 	{
@@ -544,8 +687,8 @@ typename AVLTree<T>::Node* AVLTree<T>::leftRotate (typename AVLTree<T>::Node* a)
 	return b;
 }
 
-template <typename T>
-typename AVLTree<T>::Node* AVLTree<T>::rightRotate (typename AVLTree<T>::Node* b)
+template <typename T, typename Pool>
+typename AVLTree<T, Pool>::Node* AVLTree<T, Pool>::rightRotate (typename AVLTree<T, Pool>::Node* b)
 {
 	if (b->balance_ != -2)
 	{
@@ -596,8 +739,8 @@ typename AVLTree<T>::Node* AVLTree<T>::rightRotate (typename AVLTree<T>::Node* b
 	return a;
 }
 
-template <typename T>
-typename AVLTree<T>::Node* AVLTree<T>::bigLeftRotate (typename AVLTree<T>::Node* a)
+template <typename T, typename Pool>
+typename AVLTree<T, Pool>::Node* AVLTree<T, Pool>::bigLeftRotate (typename AVLTree<T, Pool>::Node* a)
 {
 	if (a->balance_ != 2)
 	{
@@ -660,8 +803,8 @@ typename AVLTree<T>::Node* AVLTree<T>::bigLeftRotate (typename AVLTree<T>::Node*
 	return b;
 }
 
-template <typename T>
-typename AVLTree<T>::Node* AVLTree<T>::bigRightRotate (typename AVLTree<T>::Node* c)
+template <typename T, typename Pool>
+typename AVLTree<T, Pool>::Node* AVLTree<T, Pool>::bigRightRotate (typename AVLTree<T, Pool>::Node* c)
 {
 	if (c->balance_ != -2)
 	{
@@ -0,0 +1,99 @@
+#ifndef AnfPolynomial_
+#define AnfPolynomial_
+
+#include <bit>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Полином Жегалкина: множество конъюнкций (мономов) по модулю 2.
+// Моном - маска номеров переменных: разряд p соответствует переменной
+// x<vars_[p]>, пустая маска - константа 1.
+class AnfPolynomial
+{
+	std::vector<unsigned> vars_; // номера переменных по возрастанию.
+	std::vector<uint64_t> monomials_;
+
+public:
+	AnfPolynomial ()
+	{}
+	AnfPolynomial (std::vector<unsigned> vars, std::vector<uint64_t> monomials)
+		: vars_ (std::move (vars)), monomials_ (std::move (monomials))
+	{}
+
+	const std::vector<unsigned>& vars () const
+	{
+		return vars_;
+	}
+	const std::vector<uint64_t>& monomials () const
+	{
+		return monomials_;
+	}
+	size_t size () const
+	{
+		return monomials_.size ();
+	}
+
+	// Наибольшее число переменных в мономе, 0 для констант.
+	int degree () const
+	{
+		int result = 0;
+		for (uint64_t m : monomials_)
+		{
+			int d = std::popcount (m);
+			if (d > result)
+			{
+				result = d;
+			}
+		}
+
+		return result;
+	}
+	bool is_linear () const
+	{
+		return degree () <= 1;
+	}
+
+	operator std::string () const
+	{
+		if (monomials_.empty ())
+		{
+			return "0";
+		}
+
+		std::string result;
+		for (uint64_t m : monomials_)
+		{
+			if (!result.empty ())
+			{
+				result += " + ";
+			}
+
+			if (m == 0)
+			{
+				result += "1";
+				continue;
+			}
+
+			bool first = true;
+			for (size_t p = 0; p < vars_.size (); ++p)
+			{
+				if ((m >> p) & 1)
+				{
+					if (!first)
+					{
+						result += " & ";
+					}
+					result += "x";
+					result += std::to_string (vars_[p]);
+					first = false;
+				}
+			}
+		}
+
+		return result;
+	}
+};
+
+#endif // AnfPolynomial_
@@ -0,0 +1,103 @@
+#ifndef Arena_
+#define Arena_
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+// Линейный распределитель памяти: объекты размещаются подряд в блоках
+// и освобождаются все сразу, деструкторы не вызываются.
+// Первый блок - ровно под первый запрос, каждый следующий хотя бы вдвое
+// больше предыдущего, так что маленькие выражения не держат лишней памяти,
+// а число блоков растёт как логарифм общего размера.
+// Подходит только для объектов, не владеющих другими ресурсами.
+class Arena
+{
+	std::vector<std::unique_ptr<char[]>> blocks_;
+	char* current_; // свободная часть последнего блока.
+	size_t left_;
+	size_t block_; // размер последнего блока.
+
+	void grow (size_t size)
+	{
+		if (size < 2 * block_)
+		{
+			size = 2 * block_;
+		}
+
+		blocks_.emplace_back (new char[size]);
+		current_ = blocks_.back ().get ();
+		left_ = size;
+		block_ = size;
+	}
+
+public:
+	Arena () : current_ (nullptr), left_ (0), block_ (0)
+	{}
+
+	Arena (Arena&& other) noexcept : blocks_ (std::move (other.blocks_)), current_ (other.current_), left_ (other.left_), block_ (other.block_)
+	{
+		other.current_ = nullptr;
+		other.left_ = 0;
+		other.block_ = 0;
+	}
+	Arena& operator=(Arena&& other) noexcept
+	{
+		if (this != &other)
+		{
+			blocks_ = std::move (other.blocks_);
+			current_ = other.current_;
+			left_ = other.left_;
+			block_ = other.block_;
+
+			other.current_ = nullptr;
+			other.left_ = 0;
+			other.block_ = 0;
+		}
+
+		return *this;
+	}
+
+	// Выделяет блок хотя бы на size байт, чтобы следующие объекты легли подряд.
+	void reserve (size_t size)
+	{
+		if (size > left_)
+		{
+			grow (size);
+		}
+	}
+
+	void* allocate (size_t size, size_t align)
+	{
+		size_t pad = (align - reinterpret_cast<size_t> (current_) % align) % align;
+		if (current_ == nullptr || pad + size > left_)
+		{
+			grow (size + align);
+			pad = (align - reinterpret_cast<size_t> (current_) % align) % align;
+		}
+
+		void* result = current_ + pad;
+		current_ += pad + size;
+		left_ -= pad + size;
+
+		return result;
+	}
+
+	template <typename T, typename... Args>
+	T* make (Args&&... args)
+	{
+		return new (allocate (sizeof (T), alignof (T))) T (std::forward<Args> (args)...);
+	}
+
+	void clear ()
+	{
+		blocks_.clear ();
+		current_ = nullptr;
+		left_ = 0;
+		block_ = 0;
+	}
+};
+
+#endif // Arena_
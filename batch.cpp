@@ -0,0 +1,160 @@
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "batch.h"
+
+// Пачка подряд идущих строк входного файла.
+struct Batch
+{
+	std::string text; // строки пачки, записанные подряд.
+	std::vector<size_t> ends; // конец каждой строки в text.
+	std::string result;
+	const char* error = nullptr;
+	bool done = false;
+};
+
+const size_t BatchLines = 1024;
+const size_t BatchesPerThread = 4; // ограничивает память под незаписанные пачки.
+
+void process_lines (LineReader& in, std::ostream& out, LineHandler handler, size_t threads, std::string_view separator)
+{
+	std::string_view line;
+
+	if (threads <= 1)
+	{
+		while (in.next (line))
+		{
+			out << handler (line) << separator;
+		}
+		return;
+	}
+
+	std::mutex lock;
+	std::condition_variable ready; // для рабочих: есть пачка или работа закончена.
+	std::condition_variable finished; // для главного потока: пачка обработана.
+
+	std::deque<std::unique_ptr<Batch>> window; // пачки в порядке ввода, ещё не записанные.
+	std::deque<Batch*> queue; // пачки, ещё не взятые в обработку.
+	bool closed = false;
+	const char* error = nullptr;
+
+	auto worker = [&] ()
+	{
+		std::unique_lock<std::mutex> guard (lock);
+		for (;;)
+		{
+			ready.wait (guard, [&] { return !queue.empty () || closed || error != nullptr; });
+			if (error != nullptr || queue.empty ())
+			{
+				return;
+			}
+
+			Batch* batch = queue.front ();
+			queue.pop_front ();
+			guard.unlock ();
+
+			try
+			{
+				size_t begin = 0;
+				for (size_t end : batch->ends)
+				{
+					batch->result += handler (std::string_view (batch->text).substr (begin, end - begin));
+					batch->result += separator;
+					begin = end;
+				}
+			}
+			catch (const char* e)
+			{
+				batch->error = e;
+			}
+
+			guard.lock ();
+			batch->done = true;
+			if (batch->error != nullptr && error == nullptr)
+			{
+				error = batch->error;
+				ready.notify_all ();
+			}
+			finished.notify_one ();
+		}
+	};
+
+	// Записывает готовые пачки из начала окна, сохраняя порядок строк.
+	auto drain = [&] (std::unique_lock<std::mutex>& guard)
+	{
+		std::vector<std::unique_ptr<Batch>> ready_batches;
+		while (!window.empty () && window.front ()->done)
+		{
+			ready_batches.push_back (std::move (window.front ()));
+			window.pop_front ();
+		}
+
+		guard.unlock ();
+		for (auto& batch : ready_batches)
+		{
+			out << batch->result;
+		}
+		guard.lock ();
+	};
+
+	std::vector<std::thread> pool;
+	for (size_t i = 0; i < threads; ++i)
+	{
+		pool.emplace_back (worker);
+	}
+
+	bool more = true;
+	while (more)
+	{
+		auto batch = std::make_unique<Batch> ();
+		while (batch->ends.size () < BatchLines && (more = in.next (line)))
+		{
+			batch->text += line;
+			batch->ends.push_back (batch->text.size ());
+		}
+
+		if (batch->ends.empty ())
+		{
+			break;
+		}
+
+		std::unique_lock<std::mutex> guard (lock);
+		finished.wait (guard, [&] {
+			return window.size () < BatchesPerThread * threads || window.front ()->done || error != nullptr;
+		});
+		drain (guard);
+		if (error != nullptr)
+		{
+			break;
+		}
+
+		queue.push_back (batch.get ());
+		window.push_back (std::move (batch));
+		ready.notify_one ();
+	}
+
+	{
+		std::unique_lock<std::mutex> guard (lock);
+		closed = true;
+		ready.notify_all ();
+
+		while (!window.empty () && error == nullptr)
+		{
+			finished.wait (guard, [&] { return window.front ()->done || error != nullptr; });
+			drain (guard);
+		}
+	}
+
+	for (std::thread& t : pool)
+	{
+		t.join ();
+	}
+
+	if (error != nullptr)
+	{
+		throw error;
+	}
+}
@@ -0,0 +1,19 @@
+#ifndef Batch_
+#define Batch_
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <string_view>
+#include "linereader.h"
+
+typedef std::string (*LineHandler) (std::string_view);
+
+// Применяет handler к каждой строке in и пишет результаты в out
+// в порядке ввода, после каждого - separator. При threads > 1 строки
+// обрабатываются пачками в пуле потоков.
+// Исключение const char* из handler прекращает обработку и
+// пробрасывается вызывающему после остановки потоков.
+void process_lines (LineReader& in, std::ostream& out, LineHandler handler, size_t threads = 1, std::string_view separator = "\n");
+
+#endif // Batch_
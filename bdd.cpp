@@ -0,0 +1,267 @@
+#include "bdd.h"
+
+// Коды кэша для унарных операций, не пересекаются с таблицами.
+const uint32_t NegOp = 16;
+const uint32_t FlipOp = 17;
+const uint32_t EmptyOp = UINT32_MAX;
+
+const size_t InitialSize = 1 << 12;
+const size_t MaxCacheSize = 1 << 22;
+
+BddManager::BddManager () : unique_ (InitialSize, 0), cache_ (InitialSize, CacheEntry {EmptyOp, 0, 0, 0})
+{
+	nodes_.push_back (Node {Terminal, False, False});
+	nodes_.push_back (Node {Terminal, True, True});
+}
+
+static size_t hash_node (uint32_t var, BddRef low, BddRef high)
+{
+	uint64_t h = var * 0x9E3779B97F4A7C15ULL ^ low * 0xC2B2AE3D27D4EB4FULL ^ high * 0x165667B19E3779F9ULL;
+	return h ^ (h >> 29);
+}
+
+BddRef BddManager::make (uint32_t var, BddRef low, BddRef high)
+{
+	if (low == high)
+	{
+		return low;
+	}
+
+	size_t mask = unique_.size () - 1;
+	size_t i = hash_node (var, low, high) & mask;
+	for (; unique_[i] != 0; i = (i + 1) & mask)
+	{
+		const Node& node = nodes_[unique_[i]];
+		if (node.var == var && node.low == low && node.high == high)
+		{
+			return unique_[i];
+		}
+	}
+
+	BddRef result = nodes_.size ();
+	nodes_.push_back (Node {var, low, high});
+	unique_[i] = result;
+
+	if (2 * nodes_.size () > unique_.size ())
+	{
+		grow_unique ();
+	}
+
+	return result;
+}
+
+void BddManager::grow_unique ()
+{
+	unique_.assign (2 * unique_.size (), 0);
+	size_t mask = unique_.size () - 1;
+
+	for (BddRef f = 2; f < nodes_.size (); ++f)
+	{
+		const Node& node = nodes_[f];
+		size_t i = hash_node (node.var, node.low, node.high) & mask;
+		while (unique_[i] != 0)
+		{
+			i = (i + 1) & mask;
+		}
+		unique_[i] = f;
+	}
+
+	// Кэш растёт вместе с диаграммой, старые записи отбрасываются.
+	if (cache_.size () < nodes_.size () && cache_.size () < MaxCacheSize)
+	{
+		cache_.assign (2 * cache_.size (), CacheEntry {EmptyOp, 0, 0, 0});
+	}
+}
+
+BddManager::CacheEntry& BddManager::cache_slot (uint32_t op, BddRef a, BddRef b)
+{
+	return cache_[hash_node (op, a, b) & (cache_.size () - 1)];
+}
+
+BddRef BddManager::neg (BddRef f)
+{
+	if (f <= True)
+	{
+		return True - f;
+	}
+
+	const CacheEntry& entry = cache_slot (NegOp, f, 0);
+	if (entry.op == NegOp && entry.a == f)
+	{
+		return entry.result;
+	}
+
+	Node node = nodes_[f];
+	BddRef low = neg (node.low);
+	BddRef result = make (node.var, low, neg (node.high));
+
+	cache_slot (NegOp, f, 0) = CacheEntry {NegOp, f, 0, result};
+	return result;
+}
+
+BddRef BddManager::flip (BddRef f)
+{
+	if (f <= True)
+	{
+		return f;
+	}
+
+	const CacheEntry& entry = cache_slot (FlipOp, f, 0);
+	if (entry.op == FlipOp && entry.a == f)
+	{
+		return entry.result;
+	}
+
+	Node node = nodes_[f];
+	BddRef low = flip (node.high);
+	BddRef result = make (node.var, low, flip (node.low));
+
+	cache_slot (FlipOp, f, 0) = CacheEntry {FlipOp, f, 0, result};
+	return result;
+}
+
+BddRef BddManager::apply (BitOp op, BddRef a, BddRef b)
+{
+	if (op == BitOp::Neg)
+	{
+		return neg (a);
+	}
+
+	return apply_code (bit_op_code (op), a, b);
+}
+
+BddRef BddManager::apply_code (unsigned code, BddRef a, BddRef b)
+{
+	// Если один операнд известен, результат - константа, другой операнд
+	// или его отрицание. t0, t1 - значения при другом операнде 0 и 1.
+	unsigned t0 = 0, t1 = 0;
+	BddRef other = False;
+
+	if (a <= True && b <= True)
+	{
+		return (code >> (a << 1 | b)) & 1;
+	} else if (a <= True)
+	{
+		t0 = (code >> (a << 1)) & 1;
+		t1 = (code >> (a << 1 | 1)) & 1;
+		other = b;
+	} else if (b <= True)
+	{
+		t0 = (code >> b) & 1;
+		t1 = (code >> (2 | b)) & 1;
+		other = a;
+	} else if (a == b)
+	{
+		t0 = code & 1;
+		t1 = (code >> 3) & 1;
+		other = a;
+	}
+
+	if (other != False)
+	{
+		if (t0 == t1)
+		{
+			return t0;
+		}
+		return t1 ? other : neg (other);
+	}
+
+	// Для коммутативных операций порядок операндов не важен.
+	if (((code >> 1) & 1) == ((code >> 2) & 1) && a > b)
+	{
+		BddRef t = a;
+		a = b;
+		b = t;
+	}
+
+	const CacheEntry& entry = cache_slot (code, a, b);
+	if (entry.op == code && entry.a == a && entry.b == b)
+	{
+		return entry.result;
+	}
+
+	Node x = nodes_[a];
+	Node y = nodes_[b];
+	uint32_t var = (x.var < y.var) ? x.var : y.var;
+
+	BddRef a0 = (x.var == var) ? x.low : a;
+	BddRef a1 = (x.var == var) ? x.high : a;
+	BddRef b0 = (y.var == var) ? y.low : b;
+	BddRef b1 = (y.var == var) ? y.high : b;
+
+	BddRef low = apply_code (code, a0, b0);
+	BddRef result = make (var, low, apply_code (code, a1, b1));
+
+	cache_slot (code, a, b) = CacheEntry {code, a, b, result};
+	return result;
+}
+
+bool BddManager::zero_save (BddRef f) const
+{
+	while (f > True)
+	{
+		f = nodes_[f].low;
+	}
+
+	return f == False;
+}
+
+bool BddManager::unit_save (BddRef f) const
+{
+	while (f > True)
+	{
+		f = nodes_[f].high;
+	}
+
+	return f == True;
+}
+
+bool BddManager::is_self_dual (BddRef f)
+{
+	return neg (flip (f)) == f;
+}
+
+bool BddManager::is_monotone (BddRef f)
+{
+	std::vector<char> checked (nodes_.size (), 0);
+	return monotone (f, checked);
+}
+
+// f = x ? high : low монотонна, если low <= high и обе ветви монотонны.
+bool BddManager::monotone (BddRef f, std::vector<char>& checked)
+{
+	if (f <= True || checked[f])
+	{
+		return true;
+	}
+
+	Node node = nodes_[f];
+	if (apply_code (bit_op_code (BitOp::Impl), node.low, node.high) != True)
+	{
+		return false;
+	}
+	if (!monotone (node.low, checked) || !monotone (node.high, checked))
+	{
+		return false;
+	}
+
+	checked[f] = 1;
+	return true;
+}
+
+// Линейная функция в каждой вершине зависит от переменной существенно
+// и только через сложение: high = ~low, а low снова линейна.
+bool BddManager::is_linear (BddRef f)
+{
+	while (f > True)
+	{
+		Node node = nodes_[f];
+		if (node.high != neg (node.low))
+		{
+			return false;
+		}
+		f = node.low;
+	}
+
+	return true;
+}
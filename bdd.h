@@ -0,0 +1,98 @@
+#ifndef Bdd_
+#define Bdd_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "bitops.h"
+
+// Ссылка на вершину диаграммы. 0 и 1 - константы.
+typedef uint32_t BddRef;
+
+// Упорядоченные двоичные диаграммы решений (ROBDD).
+// Переменные упорядочены по номеру уровня: меньший номер ближе к корню.
+// Каждая функция представлена единственной вершиной, поэтому равенство
+// функций одного менеджера - равенство ссылок. Вершины не удаляются
+// до уничтожения менеджера.
+class BddManager
+{
+	struct Node
+	{
+		uint32_t var; // уровень; у констант - Terminal.
+		BddRef low; // переменная = 0.
+		BddRef high; // переменная = 1.
+	};
+
+	// Запись кэша вычисленных операций (с потерями).
+	struct CacheEntry
+	{
+		uint32_t op;
+		BddRef a;
+		BddRef b;
+		BddRef result;
+	};
+
+	static constexpr uint32_t Terminal = UINT32_MAX;
+
+	std::vector<Node> nodes_;
+	std::vector<BddRef> unique_; // открытая адресация, 0 - пустая ячейка.
+	std::vector<CacheEntry> cache_;
+
+	BddRef make (uint32_t var, BddRef low, BddRef high);
+	BddRef apply_code (unsigned code, BddRef a, BddRef b);
+	void grow_unique ();
+	CacheEntry& cache_slot (uint32_t op, BddRef a, BddRef b);
+	bool monotone (BddRef f, std::vector<char>& checked);
+
+public:
+	BddManager ();
+	BddManager (const BddManager&) = delete;
+	BddManager& operator=(const BddManager&) = delete;
+
+	static constexpr BddRef False = 0;
+	static constexpr BddRef True = 1;
+
+	BddRef constant (bool x) const
+	{
+		return x ? True : False;
+	}
+	BddRef var (uint32_t level)
+	{
+		return make (level, False, True);
+	}
+
+	BddRef neg (BddRef f);
+	BddRef apply (BitOp op, BddRef a, BddRef b);
+	// f (~x): значения всех переменных заменены противоположными.
+	BddRef flip (BddRef f);
+
+	// Количество вершин, включая константы.
+	size_t size () const
+	{
+		return nodes_.size ();
+	}
+	uint32_t level (BddRef f) const
+	{
+		return nodes_[f].var;
+	}
+	BddRef low (BddRef f) const
+	{
+		return nodes_[f].low;
+	}
+	BddRef high (BddRef f) const
+	{
+		return nodes_[f].high;
+	}
+
+	bool is_satisfiable (BddRef f) const
+	{
+		return f != False;
+	}
+	bool zero_save (BddRef f) const; // f (0, ..., 0) = 0
+	bool unit_save (BddRef f) const; // f (1, ..., 1) = 1
+	bool is_self_dual (BddRef f);
+	bool is_monotone (BddRef f);
+	bool is_linear (BddRef f);
+};
+
+#endif // Bdd_
@@ -0,0 +1,305 @@
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+#include <benchmark/benchmark.h>
+
+#include "boolexpr.h"
+#include "bitops.h"
+#include "AVLTree.h"
+
+// Включает набор команд range (0) до конца замера, затем возвращает
+// выбранный при запуске, чтобы остальные замеры шли с ним.
+class IsaScope
+{
+	BitIsa saved_;
+
+public:
+	explicit IsaScope (benchmark::State& state) : saved_ (bit_isa ())
+	{
+		BitIsa isa = static_cast<BitIsa> (state.range (0));
+		if (!bit_isa_supported (isa))
+		{
+			state.SkipWithError ("instruction set is not supported");
+			return;
+		}
+
+		bit_set_isa (isa);
+		state.SetLabel (bit_isa_name (isa));
+	}
+	IsaScope (const IsaScope&) = delete;
+	IsaScope& operator=(const IsaScope&) = delete;
+
+	~IsaScope ()
+	{
+		bit_set_isa (saved_);
+	}
+};
+
+// Все девять операций над векторами размером с таблицу 24 переменных.
+void BM_Kernels24 (benchmark::State& state)
+{
+	IsaScope isa (state);
+
+	const size_t words = TruthTable::word_count (24);
+	std::vector<uint64_t> a (words, 0x0123456789ABCDEFULL);
+	std::vector<uint64_t> b (words, 0xFEDCBA9876543210ULL);
+
+	for (auto _ : state)
+	{
+		for (int op = 0; op < 9; ++op)
+		{
+			bit_apply (static_cast<BitOp> (op), a.data (), b.data (), words);
+		}
+		benchmark::DoNotOptimize (a.data ());
+	}
+
+	state.counters["rows/s"] = benchmark::Counter (double (words) * 64 * 9 * state.iterations (), benchmark::Counter::kIsRate);
+}
+BENCHMARK (BM_Kernels24)->DenseRange (0, 2);
+
+// Случайное выражение глубины не больше depth над x1..x<vars>.
+std::string random_expression (std::mt19937& gen, int depth, int vars)
+{
+	const char ops[] = "&v+><=|^";
+	if (depth == 0 || gen () % 4 == 0)
+	{
+		return "x" + std::to_string (1 + gen () % vars);
+	}
+	if (gen () % 6 == 0)
+	{
+		return "~" + random_expression (gen, depth - 1, vars);
+	}
+
+	std::string left = random_expression (gen, depth - 1, vars);
+	std::string right = random_expression (gen, depth - 1, vars);
+	return "(" + left + " " + ops[gen () % 8] + " " + right + ")";
+}
+
+// Случайная функция от x1..x<vars> из leaves листьев (не меньше vars):
+// каждая переменная встречается хотя бы раз, листья попарно соединяются
+// случайными операциями из ops в случайном порядке.
+std::string random_function (std::mt19937& gen, int vars, int leaves, const char* ops = "&v+><=|^")
+{
+	std::vector<std::string> items;
+	for (int i = 0; i < leaves; ++i)
+	{
+		int var = (i < vars) ? i + 1 : 1 + gen () % vars;
+		items.push_back ("x" + std::to_string (var));
+	}
+
+	size_t count = strlen (ops);
+	while (items.size () > 1)
+	{
+		size_t i = gen () % items.size ();
+		std::string left = std::move (items[i]);
+		items[i] = std::move (items.back ());
+		items.pop_back ();
+
+		size_t j = gen () % items.size ();
+		items[j] = "(" + left + " " + ops[gen () % count] + " " + items[j] + ")";
+	}
+
+	return items[0];
+}
+
+// Таблица функции от 24 переменных (2^18 слов) с каждым набором команд.
+void BM_TruthTable (benchmark::State& state)
+{
+	IsaScope isa (state);
+
+	std::mt19937 gen (24);
+	BooleanExpression expr (random_function (gen, 24, 48));
+	unsigned long long rows = 0;
+
+	for (auto _ : state)
+	{
+		TruthTable t = expr.truth_table ();
+		rows += t.rows ();
+		benchmark::DoNotOptimize (t.data ());
+	}
+
+	state.counters["rows/s"] = benchmark::Counter (double (rows), benchmark::Counter::kIsRate);
+}
+BENCHMARK (BM_TruthTable)->DenseRange (0, 2);
+
+// Разбор строк: range (0) - глубина выражений, range (1) - число переменных.
+void BM_Parse (benchmark::State& state)
+{
+	std::mt19937 gen (1);
+	std::vector<std::string> lines;
+	size_t bytes = 0;
+	while (bytes < (1 << 20))
+	{
+		lines.push_back (random_expression (gen, state.range (0), state.range (1)));
+		bytes += lines.back ().size ();
+	}
+
+	for (auto _ : state)
+	{
+		for (const std::string& line : lines)
+		{
+			BooleanExpression expr (line);
+			benchmark::DoNotOptimize (&expr);
+		}
+	}
+
+	state.SetBytesProcessed (state.iterations () * bytes);
+	state.SetItemsProcessed (state.iterations () * lines.size ());
+}
+BENCHMARK (BM_Parse)->ArgsProduct ({{3, 6, 12}, {6, 24}});
+
+// Число переменных 1..24 и размер выражения - число листьев на переменную.
+void FunctionArgs (benchmark::internal::Benchmark* b)
+{
+	for (int vars : {1, 4, 8, 12, 16, 20, 24})
+	{
+		for (int size : {1, 4})
+		{
+			b->Args ({vars, size});
+		}
+	}
+}
+
+void BM_Table (benchmark::State& state)
+{
+	std::mt19937 gen (state.range (0));
+	BooleanExpression expr (random_function (gen, state.range (0), state.range (0) * state.range (1)));
+
+	for (auto _ : state)
+	{
+		std::string t = expr.table ();
+		benchmark::DoNotOptimize (t.data ());
+	}
+
+	state.counters["rows/s"] = benchmark::Counter (double (1ULL << state.range (0)) * state.iterations (), benchmark::Counter::kIsRate);
+}
+BENCHMARK (BM_Table)->Apply (FunctionArgs);
+
+void BM_Zhegalkin (benchmark::State& state)
+{
+	std::mt19937 gen (state.range (0));
+	BooleanExpression expr (random_function (gen, state.range (0), state.range (0) * state.range (1)));
+
+	for (auto _ : state)
+	{
+		AnfPolynomial p = expr.zhegalkin ();
+		benchmark::DoNotOptimize (&p);
+	}
+
+	state.counters["rows/s"] = benchmark::Counter (double (1ULL << state.range (0)) * state.iterations (), benchmark::Counter::kIsRate);
+}
+BENCHMARK (BM_Zhegalkin)->Apply (FunctionArgs);
+
+// Таблица монотонной функции проверяется целиком.
+void BM_CheckMono (benchmark::State& state)
+{
+	std::mt19937 gen (state.range (0));
+	int vars = state.range (0);
+	std::string table = BooleanExpression (random_function (gen, vars, 2 * vars, "&v")).table ();
+
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize (check_mono (table, 0, table.size ()));
+	}
+
+	state.counters["rows/s"] = benchmark::Counter (double (table.size ()) * state.iterations (), benchmark::Counter::kIsRate);
+}
+BENCHMARK (BM_CheckMono)->DenseRange (1, 24, 1);
+
+// range (0) функций от range (1) переменных. Все функции монотонны, поэтому
+// проверка не завершается досрочно и классифицирует каждую функцию.
+// Классы запоминаются для всех копий выражения, так что каждый проход
+// разбирает строки заново; разбор входит в замер, потому что остановка
+// таймера на каждом проходе стоит дороже проверки небольшой системы.
+void BM_IsFullSystem (benchmark::State& state)
+{
+	std::mt19937 gen (1);
+	int vars = state.range (1);
+	std::vector<std::string> lines;
+	for (int i = 0; i < state.range (0); ++i)
+	{
+		lines.push_back (random_function (gen, vars, 2 * vars, "&v"));
+	}
+
+	for (auto _ : state)
+	{
+		std::vector<BooleanExpression> system (lines.begin (), lines.end ());
+		benchmark::DoNotOptimize (isFullSystem (system));
+	}
+
+	state.SetItemsProcessed (state.iterations () * lines.size ());
+}
+BENCHMARK (BM_IsFullSystem)->ArgsProduct ({{16, 256}, {4, 12, 20}});
+
+// HeapPool - прежнее выделение каждого узла через new, SlabPool - блоками.
+template <typename Pool>
+void BM_AVLTreeInsert (benchmark::State& state)
+{
+	const int count = state.range (0);
+
+	for (auto _ : state)
+	{
+		AVLTree<int, Pool> tree;
+		for (int i = 0; i < count; ++i)
+		{
+			tree.insert ((i * 7919) % count);
+		}
+		benchmark::DoNotOptimize (tree.size ());
+	}
+
+	state.SetItemsProcessed (state.iterations () * count);
+}
+BENCHMARK_TEMPLATE (BM_AVLTreeInsert, HeapPool)->Range (1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE (BM_AVLTreeInsert, SlabPool)->Range (1 << 10, 1 << 18);
+
+template <typename Pool>
+void BM_AVLTreeFind (benchmark::State& state)
+{
+	const int count = state.range (0);
+	AVLTree<int, Pool> tree;
+	for (int i = 0; i < count; ++i)
+	{
+		tree.insert ((i * 7919) % count);
+	}
+
+	int key = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize (tree.find (key));
+		key = (key + 7919) % count;
+	}
+
+	state.SetItemsProcessed (state.iterations ());
+}
+BENCHMARK_TEMPLATE (BM_AVLTreeFind, HeapPool)->Range (1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE (BM_AVLTreeFind, SlabPool)->Range (1 << 10, 1 << 18);
+
+template <typename Pool>
+void BM_AVLTreeErase (benchmark::State& state)
+{
+	const int count = state.range (0);
+
+	for (auto _ : state)
+	{
+		state.PauseTiming ();
+		AVLTree<int, Pool> tree;
+		for (int i = 0; i < count; ++i)
+		{
+			tree.insert ((i * 7919) % count);
+		}
+		state.ResumeTiming ();
+
+		for (int i = 0; i < count; ++i)
+		{
+			tree.erase (tree.find (i));
+		}
+		benchmark::DoNotOptimize (tree.size ());
+	}
+
+	state.SetItemsProcessed (state.iterations () * count);
+}
+BENCHMARK_TEMPLATE (BM_AVLTreeErase, HeapPool)->Range (1 << 10, 1 << 18);
+BENCHMARK_TEMPLATE (BM_AVLTreeErase, SlabPool)->Range (1 << 10, 1 << 18);
+
+BENCHMARK_MAIN ();
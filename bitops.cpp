@@ -0,0 +1,231 @@
+#include "bitops.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define BITOPS_X86
+#endif
+
+typedef void (*BitKernel) (uint64_t*, const uint64_t*, size_t);
+
+template <BitOp Op>
+inline uint64_t apply_word (uint64_t a, uint64_t b)
+{
+	switch (Op)
+	{
+	case BitOp::Neg:
+		return ~a;
+	case BitOp::Conj:
+		return a & b;
+	case BitOp::Dis:
+		return a | b;
+	case BitOp::Add:
+		return a ^ b;
+	case BitOp::Impl:
+		return ~a | b;
+	case BitOp::Inv:
+		return a | ~b;
+	case BitOp::Equ:
+		return ~(a ^ b);
+	case BitOp::Sheff:
+		return ~(a & b);
+	case BitOp::Pier:
+		return ~(a | b);
+	}
+
+	return a;
+}
+
+template <BitOp Op>
+void scalar_kernel (uint64_t* out, const uint64_t* right, size_t n)
+{
+	for (size_t i = 0; i < n; ++i)
+	{
+		out[i] = apply_word<Op> (out[i], (Op == BitOp::Neg) ? 0 : right[i]);
+	}
+}
+
+#ifdef BITOPS_X86
+
+template <BitOp Op>
+[[gnu::target ("avx2")]] void avx2_kernel (uint64_t* out, const uint64_t* right, size_t n)
+{
+	const __m256i ones = _mm256_set1_epi64x (-1);
+	size_t i = 0;
+
+	for (; i + 4 <= n; i += 4)
+	{
+		__m256i a = _mm256_loadu_si256 ((const __m256i*) (out + i));
+		__m256i b = (Op == BitOp::Neg) ? ones : _mm256_loadu_si256 ((const __m256i*) (right + i));
+		__m256i r;
+
+		switch (Op)
+		{
+		case BitOp::Neg:
+			r = _mm256_xor_si256 (a, ones);
+			break;
+		case BitOp::Conj:
+			r = _mm256_and_si256 (a, b);
+			break;
+		case BitOp::Dis:
+			r = _mm256_or_si256 (a, b);
+			break;
+		case BitOp::Add:
+			r = _mm256_xor_si256 (a, b);
+			break;
+		case BitOp::Impl:
+			r = _mm256_or_si256 (_mm256_xor_si256 (a, ones), b);
+			break;
+		case BitOp::Inv:
+			r = _mm256_or_si256 (a, _mm256_xor_si256 (b, ones));
+			break;
+		case BitOp::Equ:
+			r = _mm256_xor_si256 (_mm256_xor_si256 (a, b), ones);
+			break;
+		case BitOp::Sheff:
+			r = _mm256_xor_si256 (_mm256_and_si256 (a, b), ones);
+			break;
+		case BitOp::Pier:
+			r = _mm256_xor_si256 (_mm256_or_si256 (a, b), ones);
+			break;
+		}
+
+		_mm256_storeu_si256 ((__m256i*) (out + i), r);
+	}
+
+	for (; i < n; ++i)
+	{
+		out[i] = apply_word<Op> (out[i], (Op == BitOp::Neg) ? 0 : right[i]);
+	}
+}
+
+// Таблица истинности операции для vpternlogq: A = out, B = right, C = out.
+// Разряд (A << 2 | B << 1 | C) не зависит от C, поэтому каждое значение
+// из bit_op_code занимает два соседних разряда.
+template <BitOp Op>
+constexpr int ternary_imm ()
+{
+	int imm = 0;
+	for (unsigned i = 0; i < 4; ++i)
+	{
+		if ((bit_op_code (Op) >> i) & 1)
+		{
+			imm |= 3 << (2 * i);
+		}
+	}
+
+	return imm;
+}
+
+template <BitOp Op>
+[[gnu::target ("avx512f")]] void avx512_kernel (uint64_t* out, const uint64_t* right, size_t n)
+{
+	constexpr int imm = ternary_imm<Op> ();
+	size_t i = 0;
+
+	for (; i + 8 <= n; i += 8)
+	{
+		__m512i a = _mm512_loadu_si512 (out + i);
+		__m512i b = (Op == BitOp::Neg) ? a : _mm512_loadu_si512 (right + i);
+		_mm512_storeu_si512 (out + i, _mm512_ternarylogic_epi64 (a, b, a, imm));
+	}
+
+	for (; i < n; ++i)
+	{
+		out[i] = apply_word<Op> (out[i], (Op == BitOp::Neg) ? 0 : right[i]);
+	}
+}
+
+#endif // BITOPS_X86
+
+#define BITOPS_TABLE(kernel) \
+	{ kernel<BitOp::Neg>, kernel<BitOp::Conj>, kernel<BitOp::Dis>, kernel<BitOp::Add>, kernel<BitOp::Impl>, \
+	  kernel<BitOp::Inv>, kernel<BitOp::Equ>, kernel<BitOp::Sheff>, kernel<BitOp::Pier> }
+
+const BitKernel ScalarKernels[9] = BITOPS_TABLE (scalar_kernel);
+#ifdef BITOPS_X86
+const BitKernel Avx2Kernels[9] = BITOPS_TABLE (avx2_kernel);
+const BitKernel Avx512Kernels[9] = BITOPS_TABLE (avx512_kernel);
+#endif
+
+bool bit_isa_supported (BitIsa isa)
+{
+	switch (isa)
+	{
+	case BitIsa::Scalar:
+		return true;
+#ifdef BITOPS_X86
+	case BitIsa::Avx2:
+		return __builtin_cpu_supports ("avx2");
+	case BitIsa::Avx512:
+		return __builtin_cpu_supports ("avx512f");
+#endif
+	default:
+		return false;
+	}
+}
+
+static BitIsa detect_isa ()
+{
+	if (bit_isa_supported (BitIsa::Avx512))
+	{
+		return BitIsa::Avx512;
+	}
+	if (bit_isa_supported (BitIsa::Avx2))
+	{
+		return BitIsa::Avx2;
+	}
+
+	return BitIsa::Scalar;
+}
+
+static const BitKernel* kernels_for (BitIsa isa)
+{
+	switch (isa)
+	{
+#ifdef BITOPS_X86
+	case BitIsa::Avx512:
+		return Avx512Kernels;
+	case BitIsa::Avx2:
+		return Avx2Kernels;
+#endif
+	default:
+		return ScalarKernels;
+	}
+}
+
+static BitIsa current_isa = detect_isa ();
+static const BitKernel* current_kernels = kernels_for (current_isa);
+
+void bit_apply (BitOp op, uint64_t* out, const uint64_t* right, size_t n)
+{
+	current_kernels[static_cast<size_t> (op)] (out, right, n);
+}
+
+BitIsa bit_isa ()
+{
+	return current_isa;
+}
+
+void bit_set_isa (BitIsa isa)
+{
+	if (!bit_isa_supported (isa))
+	{
+		throw "BitOps: unsupported instruction set";
+	}
+
+	current_isa = isa;
+	current_kernels = kernels_for (isa);
+}
+
+const char* bit_isa_name (BitIsa isa)
+{
+	switch (isa)
+	{
+	case BitIsa::Avx2:
+		return "avx2";
+	case BitIsa::Avx512:
+		return "avx512";
+	default:
+		return "scalar";
+	}
+}
@@ -0,0 +1,95 @@
+#ifndef BitOps_
+#define BitOps_
+
+#include <cstddef>
+#include <cstdint>
+
+// Поразрядные операции над упакованными таблицами истинности.
+enum class BitOp
+{
+	Neg,   // ~
+	Conj,  // &
+	Dis,   // v
+	Add,   // +
+	Impl,  // >
+	Inv,   // <
+	Equ,   // =
+	Sheff, // |
+	Pier   // ^
+};
+
+// Таблица истинности операции: разряд (a << 1 | b) - значение a op b,
+// для BitOp::Neg - значение ~a.
+constexpr unsigned bit_op_code (BitOp op)
+{
+	switch (op)
+	{
+	case BitOp::Neg:
+		return 3;
+	case BitOp::Conj:
+		return 8;
+	case BitOp::Dis:
+		return 14;
+	case BitOp::Add:
+		return 6;
+	case BitOp::Impl:
+		return 11;
+	case BitOp::Inv:
+		return 13;
+	case BitOp::Equ:
+		return 9;
+	case BitOp::Sheff:
+		return 7;
+	case BitOp::Pier:
+		return 1;
+	}
+
+	return 0;
+}
+
+// Операция по знаку в записи выражения ('~', '&', 'v', ...).
+inline BitOp bit_op (char symbol)
+{
+	switch (symbol)
+	{
+	case '~':
+		return BitOp::Neg;
+	case '&':
+		return BitOp::Conj;
+	case 'v':
+		return BitOp::Dis;
+	case '+':
+		return BitOp::Add;
+	case '>':
+		return BitOp::Impl;
+	case '<':
+		return BitOp::Inv;
+	case '=':
+		return BitOp::Equ;
+	case '|':
+		return BitOp::Sheff;
+	case '^':
+		return BitOp::Pier;
+	default:
+		throw "error";
+	}
+}
+
+// Наборы команд, для которых есть реализации операций.
+enum class BitIsa
+{
+	Scalar,
+	Avx2,
+	Avx512
+};
+
+// out[i] = out[i] op right[i], i < n. Для BitOp::Neg right не используется.
+// Реализация выбирается при запуске программы по CPUID.
+void bit_apply (BitOp op, uint64_t* out, const uint64_t* right, size_t n);
+
+BitIsa bit_isa ();
+bool bit_isa_supported (BitIsa);
+void bit_set_isa (BitIsa);
+const char* bit_isa_name (BitIsa);
+
+#endif // BitOps_
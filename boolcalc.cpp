@@ -2,7 +2,11 @@
 #include <fstream>
 #include <vector>
 #include <cstring>
+#include <thread>
 #include "boolexpr.h"
+#include "linereader.h"
+#include "batch.h"
+#include "stats.h"
 
 void help ()
 {
@@ -11,8 +15,73 @@ void help ()
 	std::cout << "-zh \t construction of the Zhegalkin polynomial\n";
 	std::cout << "-isfull \t check the system of functions for completeness\n";
 	std::cout << "-h or ? \t getting help using the program\n";
+	std::cout << "-j N \t after the file names: process -table and -zh lines in N threads (0 - all cores)\n";
+	std::cout << "--format=bin \t after the file names: write -table results as packed binary records\n";
+	std::cout << "--stats \t after the file names: print per-phase timings and counters to stderr (build with STATS=1)\n";
 }
 
+// Ключи после имён файлов: -j N, --format=bin и --stats.
+bool has_option (int argc, char* argv[], const char* option)
+{
+	for (int i = 4; i < argc; ++i)
+	{
+		if (strcmp (argv[i], option) == 0)
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+size_t jobs (int argc, char* argv[])
+{
+	for (int i = 4; i + 1 < argc; ++i)
+	{
+		if (strcmp (argv[i], "-j") == 0)
+		{
+			int n = atoi (argv[i + 1]);
+			if (n <= 0)
+			{
+				return std::thread::hardware_concurrency ();
+			}
+			return n;
+		}
+	}
+
+	return 1;
+}
+
+std::string table_line (std::string_view str)
+{
+	return BooleanExpression (str).table ();
+}
+
+std::string table_bin_line (std::string_view str)
+{
+	return BooleanExpression (str).packed_table ();
+}
+
+std::string zhegalkin_line (std::string_view str)
+{
+	return std::string (BooleanExpression (str).zhegalkin ());
+}
+
+// Печатает статистику (--stats) при любом выходе из main, в том числе
+// по ошибке открытия файлов.
+struct StatsReport
+{
+	bool enabled;
+
+	~StatsReport ()
+	{
+		if (enabled)
+		{
+			print_stats (std::cerr);
+		}
+	}
+};
+
 int main(int argc, char* argv[]){
 
 	if (argc < 2)
@@ -21,30 +90,41 @@ int main(int argc, char* argv[]){
 		return 1;
 	}
 
+	StatsReport report {has_option (argc, argv, "--stats")};
+
 	if (strcmp (argv[1], "-table") == 0)
 	{
-		std::ifstream inFile(argv[2]);
-		if (!inFile)
+		LineReader inFile (argv[2]);
+		if (!inFile.is_open ())
 		{
 			return 2;
 		}
 
-		std::ofstream outFile(argv[3]);
+		bool binary = has_option (argc, argv, "--format=bin");
+		std::ofstream outFile (argv[3], binary ? std::ios::binary : std::ios::out);
 		if (!outFile)
 		{
-			inFile.close();
 			return 3;
 		}
 
 		try 
 		{
-			char str[1024];
-			BooleanExpression c;
-			while (inFile.peek () != EOF)
+			size_t threads = jobs (argc, argv);
+			if (binary)
 			{
-				inFile.getline (str, 1024);
-				c = BooleanExpression (str);
-				outFile << c.table () << std::endl;
+				process_lines (inFile, outFile, table_bin_line, threads, "");
+			} else if (threads > 1)
+			{
+				process_lines (inFile, outFile, table_line, threads);
+			} else
+			{
+				// Таблица пишется частями, строка на всю таблицу не строится.
+				std::string_view str;
+				while (inFile.next (str))
+				{
+					BooleanExpression (str).write_table ([&] (std::string_view chunk) { outFile.write (chunk.data (), chunk.size ()); });
+					outFile << '\n';
+				}
 			}
 		}
 		catch (const char* error)
@@ -54,13 +134,12 @@ int main(int argc, char* argv[]){
 			outFile << error;
 		}
 
-		inFile.close();
 		outFile.close();
 	}
 	else if (strcmp (argv[1], "-zh") == 0)
 	{
-		std::ifstream inFile (argv[2]);
-		if (!inFile)
+		LineReader inFile (argv[2]);
+		if (!inFile.is_open ())
 		{
 			return 2;
 		}
@@ -68,20 +147,12 @@ int main(int argc, char* argv[]){
 		std::ofstream outFile (argv[3]);
 		if (!outFile)
 		{
-			inFile.close ();
 			return 3;
 		}
 
 		try 
 		{
-			char str[1024];
-			BooleanExpression c;
-			while (inFile.peek () != EOF)
-			{
-				inFile.getline (str, 1024);
-				c = BooleanExpression (str);
-				outFile << std::string (c.zhegalkin ()) << std::endl;
-			}
+			process_lines (inFile, outFile, zhegalkin_line, jobs (argc, argv));
 		}
 		catch (const char* error)
 		{
@@ -90,13 +161,12 @@ int main(int argc, char* argv[]){
 			outFile << error;
 		}
 
-		inFile.close ();
 		outFile.close ();
 	}
 	else if (strcmp (argv[1], "-isfull") == 0)
 	{
-		std::ifstream inFile (argv[2]);
-		if (!inFile)
+		LineReader inFile (argv[2]);
+		if (!inFile.is_open ())
 		{
 			return 2;
 		}
@@ -104,19 +174,17 @@ int main(int argc, char* argv[]){
 		std::ofstream outFile (argv[3]);
 		if (!outFile)
 		{
-			inFile.close ();
 			return 3;
 		}
 
 		try 
 		{
-			char str[1024];
+			std::string_view str;
 
 			std::vector<BooleanExpression> system;
 			BooleanExpression c;
-			while (inFile.peek () != EOF)
+			while (inFile.next (str))
 			{
-				inFile.getline (str, 1024);
 				c = BooleanExpression(str);
 				system.push_back(c);
 
@@ -136,7 +204,6 @@ int main(int argc, char* argv[]){
 			outFile << error;
 		}
 
-		inFile.close ();
 		outFile.close ();
 	}
 	else if (strcmp (argv[1], "-h") == 0 || strcmp (argv[1], "?") == 0)
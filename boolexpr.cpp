@@ -1,240 +1,304 @@
 #include <cstring>
+#include <algorithm>
 #include "boolexpr.h"
-#include <stack>
-
-BooleanExpression::BooleanExpression (const char* str) : root_ (nullptr), str_(str)
+#include "nodefactory.h"
+#include "parser.h"
+#include "stats.h"
+#include <thread>
+#include <bit>
+#include <utility>
+
+BooleanExpression::BooleanExpression (const char* str) : BooleanExpression (std::string_view (str))
+{}
+BooleanExpression::BooleanExpression (std::string_view str)
 {
-	size_t len = strlen (str);
-	len = (len < 10) ? 20 : 2 * len;
-
-	str_infix = new char[len];
-	char* str_postfix = new char[len];
+	std::shared_ptr<Compiled> compiled = std::make_shared<Compiled> ();
+	compiled->infix.resize (3 * str.size () + 1);
 
-	try
-	{
-		InfixFilter (str, str_infix);
-		Infix2Postfix (str_infix, str_postfix);
-		root_ = Postfix2Tree (str_postfix);
+	//         .
+	//      ,  Arena  .
+	const size_t ReserveNodes = 256;
+	compiled->nodes.reserve (std::min (str.size () / 6 + 1, ReserveNodes) * sizeof (ConjNode));
+	NodeFactory factory (compiled->nodes);
+	ExprParser parser (str, compiled->infix.data (), factory);
 
-	} catch (...)
 	{
-		delete[] str_postfix;
-		throw;
+		STATS_PHASE (Parse);
+		compiled->root = parser.parse ();
+		compiled->vars = parser.variables ();
+		compiled->infix.resize (strlen (compiled->infix.c_str ()));
+		compiled->infix.shrink_to_fit ();
 	}
+	compiled->node_limit = factory.size ();
+	compiled->removed = factory.simplified ();
+	STATS_ADD (Expressions, 1);
+	STATS_ADD (Nodes, factory.size ());
+	STATS_ADD (RemovedNodes, compiled->removed);
+	STATS_ADD (Vars, compiled->vars.size ());
 
-	delete[] str_postfix;
-}
-BooleanExpression::BooleanExpression (const BooleanExpression& other) : root_ (nullptr), str_ (other.str_)
-{
-	size_t len = strlen (str_);
-	len = (len < 10) ? 20 : 2 * len;
-
-	str_infix = new char[len];
-	char* str_postfix = new char[len];
-
-	try
 	{
-		InfixFilter (str_, str_infix);
-		Infix2Postfix (str_infix, str_postfix);
-		root_ = Postfix2Tree (str_postfix);
-		
-	} catch (...)
-	{
-		delete[] str_postfix;
-		throw;
+		STATS_PHASE (Compile);
+		compiled->program = Tree2Program (compiled->root, compiled->node_limit);
 	}
 
-	delete[] str_postfix;
+	compiled_ = std::move (compiled);
 }
+BooleanExpression::BooleanExpression (const BooleanExpression& other) = default;
 BooleanExpression::BooleanExpression (BooleanExpression&& other) noexcept
-{
-	workspace_ = other.workspace_;
-	other.workspace_.empty ();
+	: compiled_ (std::exchange (other.compiled_, empty ()))
+{}
 
-	str_ = other.str_;
-	str_infix = other.str_infix;
-	other.str_infix = new char[1];
-	other.str_infix[0] = '\0';
-
-	root_ = other.root_;
-	other.root_ = nullptr;
+const std::shared_ptr<const BooleanExpression::Compiled>& BooleanExpression::empty ()
+{
+	static const std::shared_ptr<const Compiled> result = std::make_shared<const Compiled> ();
+	return result;
 }
 
-bool BooleanExpression::calc ()
+TruthTable BooleanExpression::truth_table (size_t threads) const
 {
-	if (root_ != nullptr)
+	if (compiled_->vars.size () > TruthTable::MaxVars)
 	{
-		return root_->calc (workspace_);
+		throw "error";
 	}
 
-	return 0;
-}
-std::string BooleanExpression::table ()
-{
-	size_t size = workspace_.size();
-	if (size == 0)
+	STATS_PHASE (Table);
+	TruthTable result (compiled_->vars.size ());
+	STATS_ADD (Rows, result.rows ());
+
+	if (compiled_->program.size () == 0)
 	{
-		return (calc ()) ? "1" : "0";
+		return result;
 	}
 
-	int deg = 1 << size;
-	std::string result = "";
+	uint64_t* words = result.data ();
+	size_t count = result.words ();
 
-	for (unsigned long long i = 0; i < deg; ++i)
+	//       [first, last)   BitWorkspace.
+	auto fill = [&] (size_t first, size_t last)
 	{
-		unsigned long long mask = 1ULL << (size - 1);
-		AVLTree<VarValue>::iterator pos = workspace_.begin ();
-
-		while (mask > 0)
+		BitWorkspace bits (compiled_->vars.size ());
+		while (first < last)
 		{
-			bool bit = (i & mask) != 0;
-			(*pos).set (bit);
-			++pos;
-			mask >>= 1;
+			size_t n = last - first;
+			bits.block (first, (n < BitWorkspace::BlockWords) ? n : BitWorkspace::BlockWords);
+			compiled_->program.calc (words + first, bits);
+			first += bits.count ();
 		}
+	};
 
-		result += (calc ()) ? "1" : "0";
+	if (threads > count)
+	{
+		threads = count;
+	}
+
+	if (threads <= 1)
+	{
+		fill (0, count);
+	} else
+	{
+		std::vector<std::thread> pool;
+		for (size_t i = 0; i < threads; ++i)
+		{
+			pool.emplace_back (fill, count * i / threads, count * (i + 1) / threads);
+		}
+		for (std::thread& t : pool)
+		{
+			t.join ();
+		}
 	}
 
+	words[count - 1] &= result.tail_mask ();
+
 	return result;
 }
-BooleanExpression BooleanExpression::zhegalkin ()
+std::string BooleanExpression::table () const
+{
+	return truth_table ().to_string ();
+}
+void BooleanExpression::write_table (const TableSink& sink) const
 {
-	std::string triangle = table ();
-	char result[1024];
-	size_t index = 0;
-	int global_count = 0;
+	size_t vars = compiled_->vars.size ();
+	if (vars > TruthTable::MaxVars)
+	{
+		throw "error";
+	}
 
-	int size = triangle.size ();
-	if (triangle[0] == '1')
+	size_t count = TruthTable::word_count (vars);
+	if (vars < 6 || compiled_->program.size () == 0 || count * 64 <= ChunkRows)
 	{
-		result[index++] = '1';
-		++global_count;
+		sink (table ());
+		return;
 	}
 
-	int start = 1;
-	while (start < size)
+	STATS_PHASE (Table);
+	STATS_ADD (Rows, 64 * count);
+
+	const size_t ChunkWords = ChunkRows / 64;
+	std::vector<uint64_t> words (ChunkWords);
+	std::string text (ChunkRows, '0');
+	BitWorkspace bits (vars);
+
+	for (size_t first = 0; first < count; first += ChunkWords)
 	{
-		for (int i = size - 1; i >= start; --i)
+		size_t size = (count - first < ChunkWords) ? count - first : ChunkWords;
+		for (size_t done = 0; done < size; done += bits.count ())
 		{
-			triangle[i] = (triangle[i] != triangle[i - 1]) ? '1' : '0';
+			size_t n = size - done;
+			bits.block (first + done, (n < BitWorkspace::BlockWords) ? n : BitWorkspace::BlockWords);
+			compiled_->program.calc (words.data () + done, bits);
 		}
 
-		if (triangle[start] == '1')
-		{
-			if (global_count > 0)
-			{
-				result[index++] = '+';
-			}
-			++global_count;
+		TruthTable::to_chars (words.data (), size, text.data ());
+		sink (std::string_view (text.data (), 64 * size));
+	}
+}
+static void store_le (char* out, uint64_t x, size_t bytes)
+{
+	for (size_t i = 0; i < bytes; ++i)
+	{
+		out[i] = static_cast<char> (x >> (8 * i));
+	}
+}
 
-			size_t work_size = workspace_.size();
-			int mask = 1 << (work_size - 1);
-			AVLTree<VarValue>::iterator pos = workspace_.begin ();
-			int count = 0;
+std::string BooleanExpression::packed_table () const
+{
+	TruthTable tab = truth_table ();
+	const std::vector<uint32_t>& vars = compiled_->vars;
 
-			while (mask > 0)
-			{
-				if ((start & mask) != 0)
-				{
-					if (count > 0)
-					{
-						result[index++] = '&';
-					}
-					result[index++] = 'x';
-					result[index++] = (*pos).name () - 127 + '0';
-					++count;
-				}
+	size_t header = 4 * (1 + vars.size ());
+	header += header % 8;
+	std::string result (header + 8 * tab.words (), '\0');
+	char* out = result.data ();
 
-				++pos;
-				mask >>= 1;
-			}
-		}
-		++start;
+	store_le (out, vars.size (), 4);
+	for (size_t i = 0; i < vars.size (); ++i)
+	{
+		store_le (out + 4 * (i + 1), vars[i], 4);
 	}
 
-	if (index == 0)
+	if constexpr (std::endian::native == std::endian::little)
+	{
+		memcpy (out + header, tab.data (), 8 * tab.words ());
+	} else
 	{
-		result[index++] = '0';
+		for (size_t j = 0; j < tab.words (); ++j)
+		{
+			store_le (out + header + 8 * j, tab.data ()[j], 8);
+		}
 	}
-	result[index] = '\0';
 
-	return BooleanExpression (result);
+	return result;
 }
-
-BooleanExpression& BooleanExpression::operator=(const BooleanExpression& other)
+const std::vector<uint32_t>& BooleanExpression::variables () const
 {
-	if (this != &other)
-	{
-		delete root_;
-		delete[] str_infix;
-		workspace_.clear();
-
-		root_ = nullptr;
-		str_ = other.str_;
+	return compiled_->vars;
+}
+AnfPolynomial BooleanExpression::zhegalkin () const
+{
+	STATS_PHASE (Zhegalkin);
+	TruthTable coef = truth_table ();
+	coef.mobius ();
 
-		size_t len = strlen (str_);
-		len = (len < 10) ? 20 : 2 * len;
+	size_t size = compiled_->vars.size ();
+	std::vector<unsigned> vars (compiled_->vars.begin (), compiled_->vars.end ());
 
-		str_infix = new char[len];
-		char* str_postfix = new char[len];
+	std::vector<uint64_t> monomials;
+	const uint64_t* words = coef.data ();
 
-		try
+	for (size_t j = 0; j < coef.words (); ++j)
+	{
+		for (uint64_t word = words[j]; word != 0; word &= word - 1)
 		{
-			InfixFilter (str_, str_infix);
-			Infix2Postfix (str_infix, str_postfix);
-			root_ = Postfix2Tree (str_postfix);
+			unsigned long long m = (j << 6) + std::countr_zero (word);
 
-		} catch (...)
-		{
-			delete[] str_postfix;
-			throw;
+			//        .
+			uint64_t mask = 0;
+			for (size_t p = 0; p < size; ++p)
+			{
+				if ((m >> (size - 1 - p)) & 1)
+				{
+					mask |= 1ULL << p;
+				}
+			}
+			monomials.push_back (mask);
 		}
-
-		delete[] str_postfix;
 	}
 
-	return *this;
+	return AnfPolynomial (std::move (vars), std::move (monomials));
 }
+
+BooleanExpression& BooleanExpression::operator=(const BooleanExpression& other) = default;
 BooleanExpression& BooleanExpression::operator=(BooleanExpression&& other) noexcept
 {
 	if (this != &other)
 	{
-		delete root_;
-		delete[] str_infix;
-		workspace_.clear();
-		workspace_ = other.workspace_;
-		other.workspace_.empty();
-
-		str_ = other.str_;
-		str_infix = other.str_infix;
-		other.str_infix = new char[1];
-		other.str_infix[0] = '\0';
-
-		root_ = other.root_;
-		other.root_ = nullptr;
+		compiled_ = std::exchange (other.compiled_, empty ());
 	}
 
 	return *this;
 }
 bool BooleanExpression::is_equal(const BooleanExpression& other) const
 {
-	size_t len = strlen(str_infix);
-	if (len != strlen (other.str_infix))
+	return compiled_ == other.compiled_ || compiled_->infix == other.compiled_->infix;
+}
+static uint64_t mix (uint64_t x)
+{
+	x += 0x9E3779B97F4A7C15ULL;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+	return x ^ (x >> 31);
+}
+
+uint64_t BooleanExpression::fingerprint () const
+{
+	std::call_once (compiled_->fingerprint_once, [this] { compiled_->fingerprint = Fingerprint (); });
+	return compiled_->fingerprint;
+}
+uint64_t BooleanExpression::Fingerprint () const
+{
+	std::vector<uint64_t> samples (compiled_->vars.size () * SignatureWords);
+	for (size_t slot = 0; slot < compiled_->vars.size (); ++slot)
+	{
+		for (size_t i = 0; i < SignatureWords; ++i)
+		{
+			samples[slot * SignatureWords + i] = mix (compiled_->vars[slot] * SignatureWords + i);
+		}
+	}
+
+	uint64_t values[SignatureWords] = {};
+	if (compiled_->program.size () != 0)
+	{
+		BitWorkspace bits (compiled_->vars.size ());
+		bits.block (0, SignatureWords);
+		bits.sample (samples.data ());
+		compiled_->program.calc (values, bits);
+	}
+
+	uint64_t result = 0;
+	for (uint64_t word : values)
+	{
+		result = mix (result ^ word);
+	}
+
+	return result;
+}
+
+bool BooleanExpression::equivalent (const BooleanExpression& other) const
+{
+	if (fingerprint () != other.fingerprint ())
 	{
 		return false;
 	}
 
-	for (size_t i = 0; i < len; ++i)
+	if (compiled_->vars == other.compiled_->vars && compiled_->vars.size () <= TableVars)
 	{
-		if (str_infix[i] != other.str_infix[i])
-		{
-			return false;
-		}
+		return truth_table () == other.truth_table ();
 	}
 
-	return true;
+	BddManager manager;
+	return bdd (manager) == other.bdd (manager);
 }
+
 bool operator==(const BooleanExpression& left, const BooleanExpression& right)
 {
 	return left.is_equal(right);
@@ -242,16 +306,18 @@ bool operator==(const BooleanExpression& left, const BooleanExpression& right)
 
 BooleanExpression::operator std::string () const
 {
+	const char* str_infix = compiled_->infix.c_str ();
 	size_t i = 0;
 	std::string result = "";
 
 	unsigned char ch;
 	while ((ch = str_infix[i++]) != '\0')
 	{
-		if (ch > 127)
+		if (is_var_token (ch))
 		{
 			result += "x";
-			result += ch - 127 + '0';
+			result += std::to_string (read_var (str_infix + i - 1));
+			i += VarTokenSize - 1;
 		} 
 		else if (ch == '&' || ch == 'v' || ch == '+' || ch == '>' || ch == '<' || ch == '=' || ch == '|' || ch == '^')
 		{
@@ -268,498 +334,310 @@ BooleanExpression::operator std::string () const
 	return result;
 }
 
-BooleanExpression::~BooleanExpression ()
+//    DAG   .
+struct NodeUse
 {
-	delete root_;
-	delete[] str_infix;
-}
+	size_t count = 0; //  .
+	size_t left = 0; //       .
+	long reg = -1;
+};
 
-int BooleanExpression::InfixFilter (const char* instr, char* outstr)
+//     DAG root;   - 1.
+static void count_uses (const ExprNode* root, std::vector<NodeUse>& uses)
 {
-	size_t in = 0;
-	size_t out = 0;
-	int cnt = 0;
-
-	char ch;
-	while ((ch = instr[in++]) != '\0')
+	uses[root->index ()].count = 1;
+	post_order (root, uses.size (), [&uses] (const ExprNode* node)
 	{
-		if (ch == ' ' || ch == '\t' || ch == '\r')
+		for (size_t i = 0; node->operand (i) != nullptr; ++i)
 		{
-			continue;
+			++uses[node->operand (i)->index ()].count;
 		}
-
-		if (ch == 'x')
-		{
-			size_t tmp = in; 
-			char buf[4];
-			size_t in_buf = 0;
-
-			while (isdigit ((ch = instr[in++])) != 0 && in_buf < 3) 
-			{
-				buf[in_buf++] = ch;
-			}
-			buf[in_buf] = '\0';
-			--in;
-
-			if (in_buf != 1)
-			{
-				throw "error";
-			}
-
-			int num = atoi(buf);
-			outstr[out++] = 127 + num;
-			++cnt;
-		}
-		else if (ch == '0' || ch == '1' || ch == '(' || ch == ')' || ch == '~' 
-				 || ch == '&' || ch == 'v' || ch == '+' || ch == '>' || ch == '<' || ch == '=' || ch == '|' || ch == '^')
-		{
-			outstr[out++] = ch;
-		}
-		else
-		{
-			throw "error";
-		}
-	}
-
-	outstr[out] = '\0';
-	return cnt;
+	});
 }
 
-const unsigned char ActionsTable[][13] = {
-  // 0 ~ & v + > < = | ^ ( ) P 
-	{7,2,2,2,2,2,2,2,2,2,2,6,1}, // empty
-	{3,2,3,3,3,3,3,3,3,3,2,3,1}, // ~
-	{3,2,3,3,3,3,3,3,3,3,2,3,1}, // &
-	{3,2,2,3,3,3,3,3,3,3,2,3,1}, // v
-	{3,2,2,3,3,3,3,3,3,3,2,3,1}, // +
-	{3,2,2,2,2,3,3,3,3,3,2,3,1}, // >
-	{3,2,2,2,2,3,3,3,3,3,2,3,1}, // <
-	{3,2,2,2,2,2,2,3,3,3,2,3,1}, // =
-	{3,2,2,2,2,2,2,2,3,3,2,3,1}, // |
-	{3,2,2,2,2,2,2,2,3,3,2,3,1}, // ^
-	{5,2,2,2,2,2,2,2,2,2,2,4,1}, // (
-};
-
-/*
-	1.    outstr.
-	2.    .
-	3.      outstr.
-	4.    .
-	5.    .
-	6.    .
-	7. .
-*/
-
-int actionsRowNumber (char ch)
-{
-	switch (ch)
-	{
-	case '~': 
-		return 1;
-	case '&': 
-		return 2;
-	case 'v': 
-		return 3;
-	case '+': 
-		return 4;
-	case '>': 
-		return 5;
-	case '<': 
-		return 6;
-	case '=':
-		return 7;
-	case '|': 
-		return 8;
-	case '^': 
-		return 9;
-	case '(': 
-		return 10;
-	}
-
-	throw "error";
-}
-int actionsColNumber (unsigned char ch)
-{
-	switch (ch)
-	{
-	case 0:
-		return 0;
-	case '~': 
-		return 1;
-	case '&': 
-		return 2;
-	case 'v': 
-		return 3;
-	case '+': 
-		return 4;
-	case '>': 
-		return 5;
-	case '<': 
-		return 6;
+static void emit_op (const ExprNode* node, Program& result)
+{
+	switch (node->symbol ())
+	{
+	case '0':
+		result.emit (OpCode::Zero);
+		break;
+	case '1':
+		result.emit (OpCode::One);
+		break;
+	case 'x':
+		result.emit (OpCode::Var, static_cast<const VarNode*> (node)->slot ());
+		break;
+	case '~':
+		result.emit (OpCode::Neg);
+		break;
+	case '&':
+		result.emit (OpCode::Conj);
+		break;
+	case 'v':
+		result.emit (OpCode::Dis);
+		break;
+	case '+':
+		result.emit (OpCode::Add);
+		break;
+	case '>':
+		result.emit (OpCode::Impl);
+		break;
+	case '<':
+		result.emit (OpCode::Inv);
+		break;
 	case '=':
-		return 7;
-	case '|': 
-		return 8;
-	case '^': 
-		return 9;
-	case '(': 
-		return 10;
-	case ')': 
-		return 11;
+		result.emit (OpCode::Equ);
+		break;
+	case '|':
+		result.emit (OpCode::Sheff);
+		break;
+	case '^':
+		result.emit (OpCode::Pier);
+		break;
 	}
+}
 
-	if (ch >= 128 || ch == '0' || ch == '1')
+// ,   , ;   false.
+static bool emit_load (const ExprNode* node, Program& result, std::vector<NodeUse>& uses, std::vector<unsigned>& free)
+{
+	NodeUse& use = uses[node->index ()];
+	if (use.reg < 0)
 	{
-		return 12;
+		return false;
 	}
 
-	throw "error";
+	result.emit (OpCode::Load, use.reg);
+	if (--use.left == 0)
+	{
+		free.push_back (use.reg);
+	}
+	return true;
 }
 
-void BooleanExpression::Infix2Postfix (const char* instr, char* outstr)
+//          .
+static void emit_node (const ExprNode* root, Program& result, std::vector<NodeUse>& uses,
+                       std::vector<unsigned>& free, unsigned& registers)
 {
-	size_t in = 0;
-	size_t out = 0;
+	std::vector<std::pair<const ExprNode*, size_t>> stack; //     .
+	stack.emplace_back (root, 0);
 
-	unsigned char action;
-	std::stack<char> S;
-	size_t row;
-	size_t col;
-
-	do
+	while (!stack.empty ())
 	{
-		col = actionsColNumber(instr[in]);
-		row = (S.empty()) ? 0 : actionsRowNumber(S.top());
-		action = ActionsTable[row][col];
-
-		switch (action)
+		const ExprNode* node = stack.back ().first;
+		const ExprNode* next = node->operand (stack.back ().second++);
+		if (next != nullptr)
 		{
-		    case 1:
-				outstr[out++] = instr[in++];
-				break;
-			case 2:
-				S.push(instr[in++]);
-				break;
-			case 3:
-				outstr[out++] = S.top();
-				S.pop();
-				break;
-			case 4:
-				S.pop();
-				++in;
-				break;
-			case 5:
-				throw "error";
-				break;
-			case 6:
-				throw "error";
-				break;
-			case 7:
-				outstr[out] = '\0';
-				break;
+			if (!emit_load (next, result, uses, free))
+			{
+				stack.emplace_back (next, 0);
+			}
+			continue;
 		}
 
-	} while (action != 7);
-}
-ExprNode* BooleanExpression::Postfix2Tree (const char* str)
-{
-	size_t in = 0;
-
-	std::stack<ExprNode*> S;
-	ExprNode* result = nullptr;
-	ExprNode* left = nullptr;
-	ExprNode* right = nullptr;
+		stack.pop_back ();
+		emit_op (node, result);
 
-	unsigned char ch;
-	try
-	{ 
-		while ((ch = str[in++]) != '\0')
+		//     ;    .
+		NodeUse& use = uses[node->index ()];
+		if (use.count > 1 && node->operand (0) != nullptr)
 		{
-			switch (ch)
+			if (free.empty ())
 			{
-			case '~':
-				if (S.empty ())
-				{
-					throw 1;
-				}
-				right = S.top();
-				S.pop();
-
-				result = new NegNode(right);
-				break;
-			case '&':
-				if (S.empty()) {
-					throw 1;
-				}
-				right = S.top();
-				S.pop();
-
-				if (S.empty ())
-				{
-					throw 1;
-				}
-				left = S.top ();
-				S.pop ();
-
-				result = new ConjNode(left, right);
-				break;
-			case 'v': 
-				if (S.empty ())
-				{
-					throw 1;
-				}
-				right = S.top ();
-				S.pop ();
-
-				if (S.empty ())
-				{
-					throw 1;
-				}
-				left = S.top ();
-				S.pop ();
-
-				result = new DisNode (left, right);
-				break;
-			case '+': 
-				if (S.empty ())
-				{
-					throw 1;
-				}
-				right = S.top ();
-				S.pop ();
-
-				if (S.empty ())
-				{
-					throw 1;
-				}
-				left = S.top ();
-				S.pop ();
-
-				result = new AddNode (left, right);
-				break;
-			case '=':
-				if (S.empty ())
-				{
-					throw 1;
-				}
-				right = S.top ();
-				S.pop ();
-
-				if (S.empty ())
-				{
-					throw 1;
-				}
-				left = S.top ();
-				S.pop ();
-
-				result = new EquNode (left, right);
-				break;
-			case '>': 
-				if (S.empty ())
-				{
-					throw 1;
-				}
-				right = S.top ();
-				S.pop ();
-
-				if (S.empty ())
-				{
-					throw 1;
-				}
-				left = S.top ();
-				S.pop ();
+				use.reg = registers++;
+			} else
+			{
+				use.reg = free.back ();
+				free.pop_back ();
+			}
+			use.left = use.count - 1;
+			result.emit (OpCode::Store, use.reg);
+		}
+	}
+}
 
-				result = new ImplNode (left, right);
-				break;
-			case '<':
-				if (S.empty ())
-				{
-					throw 1;
-				}
-				right = S.top ();
-				S.pop ();
+Program BooleanExpression::Tree2Program (const ExprNode* root, size_t count)
+{
+	Program result;
+	std::vector<NodeUse> uses (count);
+	result.reserve (2 * count);
+	std::vector<unsigned> free; //  .
+	unsigned registers = 0;
 
-				if (S.empty ())
-				{
-					throw 1;
-				}
-				left = S.top ();
-				S.pop ();
+	count_uses (root, uses);
+	emit_node (root, result, uses, free, registers);
 
-				result = new InvNode (left, right);
-				break;
-			case '|': 
-				if (S.empty ())
-				{
-					throw 1;
-				}
-				right = S.top ();
-				S.pop ();
+	if (!result.complete ())
+	{
+		throw "error";
+	}
 
-				if (S.empty ())
-				{
-					throw 1;
-				}
-				left = S.top ();
-				S.pop ();
+	return result;
+}
 
-				result = new SheffNode (left, right);
-				break;
-			case '^': 
-				if (S.empty ())
-				{
-					throw 1;
-				}
-				right = S.top ();
-				S.pop ();
+static size_t count_nodes (const ExprNode* root, size_t count)
+{
+	size_t result = 0;
+	post_order (root, count, [&result] (const ExprNode*) { ++result; });
+	return result;
+}
 
-				if (S.empty ())
-				{
-					throw 1;
-				}
-				left = S.top ();
-				S.pop ();
+size_t BooleanExpression::node_count () const
+{
+	return (compiled_->root == nullptr) ? 0 : count_nodes (compiled_->root, compiled_->node_limit);
+}
+size_t BooleanExpression::removed_nodes () const
+{
+	return compiled_->removed;
+}
 
-				result = new PierNode (left, right);
-				break;
-			case '0':
-				result = new NumNode (false);
-				break;
-			case '1':
-				result = new NumNode (true);
-				break;
-			default:
-				if (ch >= 128)
-				{
-					result = new VarNode(ch, workspace_);
-				}
-			}
+// size  str,   start, -  , size -  .
+bool check_mono (const std::string& str, int start, int size)
+{
+	if (size <= 1)
+	{
+		return true;
+	}
+	if (!std::has_single_bit (unsigned (size)))
+	{
+		throw "error";
+	}
 
-			S.push(result);
-		}
+	size_t vars = std::countr_zero (unsigned (size));
+	TruthTable tab (vars);
 
-		if (S.size () != 1)
-		{
-			throw 1;
-		}
+	for (int i = 0; i < size; ++i)
+	{
+		tab.set (i, str[start + i] == '1');
+	}
 
-		return S.top();
+	return tab.is_monotone ();
+}
+BddRef BooleanExpression::bdd (BddManager& manager) const
+{
+	if (compiled_->root == nullptr)
+	{
+		return BddManager::False;
 	}
-	catch (int error)
+
+	//   -  ,     .
+	const uint32_t* levels = compiled_->vars.data ();
+	std::vector<BddRef> done (compiled_->node_limit);
+	post_order (compiled_->root, compiled_->node_limit, [&] (const ExprNode* node)
 	{
-		while (!S.empty())
+		BddRef result;
+		switch (node->symbol ())
 		{
-			result = S.top();
-			S.pop();
-			delete result;
+		case '0':
+		case '1':
+			result = manager.constant (node->symbol () == '1');
+			break;
+		case 'x':
+			result = manager.var (levels[static_cast<const VarNode*> (node)->slot ()]);
+			break;
+		case '~':
+			result = manager.neg (done[node->operand (0)->index ()]);
+			break;
+		default:
+			result = manager.apply (bit_op (node->symbol ()), done[node->operand (0)->index ()], done[node->operand (1)->index ()]);
 		}
 
-		throw "error";
-	}
+		done[node->index ()] = result;
+	});
+
+	return done[compiled_->root->index ()];
 }
 
-bool check_mono (const std::string& str, int start, int size)
+bool BooleanExpression::is_satisfiable () const
 {
-	int half_size = size >> 1;
-	if (size <= 2)
+	if (compiled_->vars.size () > TableVars)
 	{
-		return str[start] <= str[start + half_size];
+		BddManager manager;
+		return manager.is_satisfiable (bdd (manager));
 	}
 
-	bool res1 = check_mono (str, start, half_size);
-	bool res2 = check_mono (str, start + half_size, half_size);
-
-	if (res1 && res2)
+	TruthTable tab = truth_table ();
+	for (size_t j = 0; j < tab.words (); ++j)
 	{
-		int half = start + half_size;
-		int end = start + size;
-
-		for (int i = start; i < half; ++i)
+		if (tab.data ()[j] != 0)
 		{
-			for (int j = half; j < end; ++j)
-			{
-				if (str[i] > str[j])
-				{
-					return false;
-				}
-			}
+			return true;
 		}
-		return true;
 	}
 
 	return false;
 }
-bool isFullSystem (std::vector<BooleanExpression>& system)
-{
-	int no_unit_save = 0;
-	int no_zero_save = 0;
-	int no_self_dual = 0;
-	int no_mono = 0;
-	int no_linear = 0;
 
-	for (auto pos = system.begin(); pos != system.end(); ++pos)
+const PostClassification& BooleanExpression::classification () const
+{
+	std::call_once (compiled_->post_once, [this] { compiled_->post = Classify (); });
+	return compiled_->post;
+}
+PostClassification BooleanExpression::Classify () const
+{
+	STATS_PHASE (Classify);
+	if (compiled_->vars.size () > TableVars)
 	{
-		//     5 .
-		std::string tab = (*pos).table ();
+		BddManager manager;
+		BddRef f = bdd (manager);
+		return PostClassification {
+			manager.zero_save (f),
+			manager.unit_save (f),
+			manager.is_self_dual (f),
+			manager.is_monotone (f),
+			manager.is_linear (f)
+		};
+	}
 
-		// no_zero_save
-		if (tab.front() == '1')
-		{
-			++no_zero_save;
-		}
+	TruthTable tab = truth_table ();
+	PostClassification result;
 
-		// no_unit_save
-		if (tab.back() == '0')
-		{
-			++no_unit_save;
-		}
+	result.zero_save = !tab.get (0);
+	result.unit_save = tab.get (tab.rows () - 1);
+	result.self_dual = tab.is_self_dual ();
+	result.monotone = tab.is_monotone ();
 
-		// no_self_dual
-		bool is_self_dual = true;
-		for (int i = 0, j = tab.size () - 1; i < j; ++i, --j)
+	// ,         1.
+	tab.mobius ();
+	result.linear = true;
+	for (size_t j = 0; j < tab.words () && result.linear; ++j)
+	{
+		for (uint64_t word = tab.data ()[j]; word != 0; word &= word - 1)
 		{
-			if (tab[i] == tab[j])
+			if (std::popcount ((j << 6) + std::countr_zero (word)) > 1)
 			{
-				is_self_dual = false;
+				result.linear = false;
 				break;
 			}
 		}
+	}
 
-		if (!is_self_dual)
-		{
-			++no_self_dual;
-		}
-
-		// no_mono
-		if (!check_mono (tab, 0, tab.size ()))
-		{
-			++no_mono;
-		}
-		
-		// no_linear
-		std::string zh = std::string((*pos).zhegalkin());
+	return result;
+}
 
-		bool is_linear = true;
-		for (auto ch : zh)
-		{
-			if (ch == '&')
-			{
-				is_linear = false;
-				break;
-			}
-		}
+PostClassification classify (std::span<const BooleanExpression> system)
+{
+	PostClassification result = { true, true, true, true, true };
 
-		if (!is_linear)
+	for (const BooleanExpression& f : system)
+	{
+		const PostClassification& c = f.classification ();
+		result.zero_save = result.zero_save && c.zero_save;
+		result.unit_save = result.unit_save && c.unit_save;
+		result.self_dual = result.self_dual && c.self_dual;
+		result.monotone = result.monotone && c.monotone;
+		result.linear = result.linear && c.linear;
+
+		if (result.is_complete ())
 		{
-			++no_linear;
+			break;
 		}
 	}
 
-	if (no_unit_save > 0 && no_zero_save > 0 && no_self_dual > 0 && no_mono > 0 && no_linear > 0)
-	{
-		return true;
-	}
-
-	return false;
+	return result;
 }
 
+bool isFullSystem (std::vector<BooleanExpression>& system)
+{
+	return classify (system).is_complete ();
+}
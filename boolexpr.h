@@ -2,39 +2,122 @@
 #define BoolExpr_
 
 #include <string>
+#include <string_view>
+#include <span>
+#include <mutex>
+#include <functional>
+#include <memory>
 #include <vector>
 #include "exprnodes.h"
+#include "truthtable.h"
+#include "bdd.h"
+#include "program.h"
+#include "arena.h"
+#include "anf.h"
+
+// Принадлежность функции (или всех функций системы) классам Поста.
+struct PostClassification
+{
+	bool zero_save; // T0: f(0, ..., 0) = 0.
+	bool unit_save; // T1: f(1, ..., 1) = 1.
+	bool self_dual; // S
+	bool monotone; // M
+	bool linear; // L
+
+	// Система полна, если она не лежит целиком ни в одном из классов.
+	bool is_complete () const
+	{
+		return !zero_save && !unit_save && !self_dual && !monotone && !linear;
+	}
+};
+
+// Получатель очередной части таблицы истинности.
+typedef std::function<void (std::string_view)> TableSink;
 
 class BooleanExpression
 {
-	AVLTree<VarValue> workspace_;
-	ExprNode* root_;
-	const char* str_;
-	char* str_infix;
+	// Разобранное выражение. После построения не изменяется (кроме кэшей
+	// в конце) и разделяется копиями BooleanExpression, поэтому
+	// копирование - копирование указателя.
+	struct Compiled
+	{
+		std::vector<uint32_t> vars; // номера переменных по возрастанию, индекс - номер ячейки.
+		Arena nodes; // владеет всеми узлами дерева root.
+		ExprNode* root = nullptr;
+		size_t node_limit = 0; // номера узлов в nodes меньше node_limit.
+		Program program;
+		size_t removed = 0; // сколько операций заменило упрощение.
+		std::string infix; // запись выражения во внутреннем виде (см. vartable.h).
 
-	int InfixFilter (const char*, char*);
-	void Infix2Postfix (const char*, char*);
-	ExprNode* Postfix2Tree (const char*);
-	bool calc ();
+		// Вычисляются при первом запросе один раз для всех копий,
+		// в том числе при одновременных запросах из разных потоков.
+		mutable std::once_flag post_once;
+		mutable PostClassification post;
+		mutable std::once_flag fingerprint_once;
+		mutable uint64_t fingerprint = 0;
+	};
+
+	std::shared_ptr<const Compiled> compiled_;
+
+	// Пустое выражение; остаётся в объекте, из которого выполнено перемещение.
+	static const std::shared_ptr<const Compiled>& empty ();
+	PostClassification Classify () const;
+	uint64_t Fingerprint () const;
+	static Program Tree2Program (const ExprNode*, size_t);
 
 public:
 	BooleanExpression (const char* str = "0");
+	BooleanExpression (std::string_view);
 	BooleanExpression (const BooleanExpression&);
 	BooleanExpression (BooleanExpression&&) noexcept;
 
-	std::string table ();
-	BooleanExpression zhegalkin ();
+	// Таблица строится не более чем для TruthTable::MaxVars переменных.
+	// При threads > 1 строки таблицы делятся между потоками.
+	TruthTable truth_table (size_t threads = 1) const;
+	std::string table () const;
+	// Та же строка, что table (), частями по ChunkRows символов (последняя
+	// часть может быть короче). Таблица целиком в памяти не хранится.
+	void write_table (const TableSink&) const;
+	static constexpr size_t ChunkRows = 1 << 16;
+	// Запись таблицы в двоичном виде: uint32 число переменных n, n номеров
+	// переменных (uint32, по возрастанию), 4 нулевых байта при чётном n,
+	// затем TruthTable::word_count (n) слов uint64 (см. TruthTable).
+	// Все числа little-endian, таблица выровнена на 8 байт от начала записи.
+	std::string packed_table () const;
+	// Номера переменных выражения по возрастанию.
+	const std::vector<uint32_t>& variables () const;
+	AnfPolynomial zhegalkin () const;
+	// Диаграмма решений в manager. Уровень переменной - её номер, так что
+	// диаграммы разных выражений в одном менеджере можно сравнивать.
+	BddRef bdd (BddManager& manager) const;
+	bool is_satisfiable () const;
+	// Количество узлов DAG: повторяющиеся подвыражения хранятся один раз.
+	size_t node_count () const;
+	// Сколько операций при разборе упрощение заменило более простыми узлами (см. simplify.h).
+	size_t removed_nodes () const;
+	// До TableVars переменных классы определяются по таблице истинности,
+	// для более широких функций - по диаграмме решений.
+	const PostClassification& classification () const;
+	static constexpr size_t TableVars = 16;
 	
 	BooleanExpression& operator=(const BooleanExpression&);
 	BooleanExpression& operator=(BooleanExpression&&) noexcept;
 	bool is_equal (const BooleanExpression&) const;
-	operator std::string () const;
 
-	~BooleanExpression ();
+	// Свёртка значений функции на SignatureWords * 64 псевдослучайных наборах.
+	// Набор зависит только от номеров переменных, поэтому у равносильных
+	// выражений отпечатки совпадают.
+	uint64_t fingerprint () const;
+	static constexpr size_t SignatureWords = 4;
+	// Равносильность: различие отпечатков, затем сравнение таблиц
+	// (одинаковые переменные, до TableVars) или диаграмм решений.
+	bool equivalent (const BooleanExpression&) const;
+	operator std::string () const;
 };
 
 bool operator==(const BooleanExpression&, const BooleanExpression&);
 bool check_mono (const std::string&, int, int);
+PostClassification classify (std::span<const BooleanExpression>);
 bool isFullSystem (std::vector<BooleanExpression>&);
 
 #endif // BoolExpr_
\ No newline at end of file
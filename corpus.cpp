@@ -0,0 +1,86 @@
+#include <charconv>
+#include "corpus.h"
+
+const char BinaryOps[] = "&v+><=|^";
+
+CorpusGenerator::CorpusGenerator (const CorpusOptions& options)
+	: options_ (options), state_ (options.seed), sharing_ (options.sharing * (1 << 16))
+{
+	if (options_.vars == 0)
+	{
+		options_.vars = 1;
+	}
+}
+
+// splitmix64
+uint64_t CorpusGenerator::next ()
+{
+	uint64_t x = (state_ += 0x9E3779B97F4A7C15ULL);
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+	return x ^ (x >> 31);
+}
+
+void CorpusGenerator::variable (std::string& out)
+{
+	char buffer[16] = {'x'};
+	char* end = std::to_chars (buffer + 1, buffer + sizeof (buffer), 1 + next_below (options_.vars)).ptr;
+	out.append (buffer, end);
+}
+
+// Возвращает глубину записанного подвыражения.
+unsigned CorpusGenerator::expression (std::string& out, unsigned depth)
+{
+	if (depth > 0 && !parts_.empty () && next_below (1 << 16) < sharing_)
+	{
+		const Part& part = parts_[next_below (parts_.size ())];
+		if (part.depth <= depth)
+		{
+			// Место резервируется заранее: копируемая часть лежит в том же буфере.
+			out.reserve (out.size () + part.size);
+			out.append (out.data () + part.pos, part.size);
+			return part.depth;
+		}
+	}
+
+	// Всё выражение - не лист, если глубина позволяет.
+	uint32_t choice = (depth == options_.depth) ? 4 + next_below (12) : next_below (16);
+	if (depth == 0 || choice < 4)
+	{
+		if (choice == 0)
+		{
+			out += (next () & 1) ? '1' : '0';
+		} else
+		{
+			variable (out);
+		}
+		return 0;
+	}
+
+	size_t pos = out.size ();
+	unsigned result;
+	if (choice < 6)
+	{
+		out += '~';
+		result = expression (out, depth - 1) + 1;
+	} else
+	{
+		out += '(';
+		unsigned left = expression (out, depth - 1);
+		out += ' ';
+		out += BinaryOps[next_below (8)];
+		out += ' ';
+		unsigned right = expression (out, depth - 1);
+		out += ')';
+		result = ((left > right) ? left : right) + 1;
+	}
+
+	parts_.push_back (Part {pos, out.size () - pos, result});
+	return result;
+}
+
+void CorpusGenerator::line (std::string& out)
+{
+	parts_.clear ();
+	expression (out, options_.depth);
+}
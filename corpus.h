@@ -0,0 +1,52 @@
+#ifndef Corpus_
+#define Corpus_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Параметры случайных выражений для нагрузочных замеров.
+struct CorpusOptions
+{
+	uint32_t vars = 8; // переменные x1..x<vars>.
+	unsigned depth = 6; // наибольшая глубина выражения.
+	double sharing = 0.0; // доля подвыражений, повторяющих уже записанные в строке.
+	uint64_t seed = 1;
+};
+
+// Генератор корректных выражений со всеми девятью операциями.
+// При одинаковых параметрах выдаёт одну и ту же последовательность строк.
+class CorpusGenerator
+{
+	// Записанное подвыражение строки: out[pos, pos + size).
+	struct Part
+	{
+		size_t pos;
+		size_t size;
+		unsigned depth;
+	};
+
+	CorpusOptions options_;
+	uint64_t state_;
+	uint32_t sharing_; // порог для next_below (1 << 16).
+	std::vector<Part> parts_;
+
+	uint64_t next ();
+	// Равномерно в [0, n).
+	uint32_t next_below (uint32_t n)
+	{
+		return ((next () >> 32) * n) >> 32;
+	}
+
+	unsigned expression (std::string& out, unsigned depth);
+	void variable (std::string& out);
+
+public:
+	explicit CorpusGenerator (const CorpusOptions&);
+
+	// Дописывает в out следующее выражение без перевода строки.
+	void line (std::string& out);
+};
+
+#endif // Corpus_
@@ -3,47 +3,121 @@
 
 #include <iostream>
 #include <string>
-#include "AVLTree.h"
+#include <vector>
+#include <cstdint>
+#include "truthtable.h"
 
-class VarValue
+//     :
+//   count_ ,    first_,    64   .
+class BitWorkspace
 {
-	const unsigned char name_;
-	bool data_;
+	size_t vars_; //    slot   vars_ - 1 - slot  .
+	size_t first_;
+	size_t count_;
+
+	std::vector<std::vector<uint64_t>> stack_; //    .
+	size_t top_;
+	const uint64_t* samples_; //     .
 
 public:
-	VarValue (unsigned char x, bool val) : name_ (x), data_ (val)
+	static constexpr size_t BlockWords = 64;
+
+	BitWorkspace (size_t vars = 0) : vars_ (vars), first_ (0), count_ (0), top_ (0), samples_ (nullptr)
 	{}
 
-	void set (bool x)
+	size_t vars () const
+	{
+		return vars_;
+	}
+
+	void block (size_t first, size_t count)
 	{
-		data_ = x;
+		first_ = first;
+		count_ = count;
 	}
-	bool get () const
+	size_t first () const
 	{
-		return data_;
+		return first_;
+	}
+	size_t count () const
+	{
+		return count_;
 	}
 
-	unsigned char name ()
+	//    slot   values[slot * count + i]
+	//     ; nullptr   .
+	void sample (const uint64_t* values)
 	{
-		return name_;
+		samples_ = values;
 	}
 
-	bool operator<(const VarValue& other) const
+	//     slot    .
+	void load (uint64_t* out, size_t slot) const
 	{
-		return name_ < other.name_;
+		if (samples_ != nullptr)
+		{
+			for (size_t i = 0; i < count_; ++i)
+			{
+				out[i] = samples_[slot * count_ + i];
+			}
+			return;
+		}
+
+		size_t shift = vars_ - 1 - slot;
+
+		if (shift < 6)
+		{
+			for (size_t i = 0; i < count_; ++i)
+			{
+				out[i] = RowPatterns[shift];
+			}
+			return;
+		}
+
+		for (size_t i = 0; i < count_; ++i)
+		{
+			out[i] = (((first_ + i) >> (shift - 6)) & 1) ? ~0ULL : 0;
+		}
 	}
-	bool operator==(const VarValue& other) const
+
+	uint64_t* alloc ()
 	{
-		return name_ == other.name_;
+		if (top_ == stack_.size ())
+		{
+			stack_.emplace_back (BlockWords);
+		}
+
+		return stack_[top_++].data ();
+	}
+	void release ()
+	{
+		--top_;
 	}
 };
 
 //--------------------------------
 
+//    Arena      .
 class ExprNode
 {
+	unsigned index_ = 0; //      (. NodeFactory).
 public:
-	virtual bool calc(AVLTree<VarValue>& workspace) const = 0;
+	unsigned index () const
+	{
+		return index_;
+	}
+	void set_index (unsigned index)
+	{
+		index_ = index;
+	}
+
+	//     ; '0', '1' - , 'x' - .
+	virtual char symbol () const = 0;
+	//   , nullptr  .
+	virtual ExprNode* operand (size_t) const
+	{
+		return nullptr;
+	}
 	virtual ~ExprNode() {};
 };
 
@@ -54,9 +128,9 @@ class NumNode : public ExprNode
 	const bool num_;
 public:
 	NumNode(bool x) : num_(x) {}
-	bool calc (AVLTree<VarValue>& workspace) const
+	char symbol () const
 	{
-		return num_;
+		return num_ ? '1' : '0';
 	}
 };
 
@@ -64,23 +138,23 @@ public:
 
 class VarNode : public ExprNode
 {
-	const unsigned char name_;
+	size_t slot_; //      .
 
 public:
-	VarNode (unsigned char x, AVLTree<VarValue>& workspace) : name_(x)
+	VarNode (size_t slot) : slot_(slot)
+	{}
+	char symbol () const
 	{
-		VarValue tmp(name_, false);
-
-		AVLTree<VarValue>::iterator pos = workspace.find(tmp);
-		if (pos == workspace.end ())
-		{
-			workspace.insert(tmp);
-		}
+		return 'x';
+	}
+	size_t slot () const
+	{
+		return slot_;
 	}
-	bool calc (AVLTree<VarValue>& workspace) const
+	//   ,    .
+	void bind (size_t slot)
 	{
-		AVLTree<VarValue>::iterator pos = workspace.find (VarValue(name_, false));
-		return (*pos).get();
+		slot_ = slot;
 	}
 };
 
@@ -94,10 +168,9 @@ protected:
 
 public:
 	BinNode(ExprNode* L, ExprNode* R) : left_(L), right_(R) {}
-	~BinNode ()
+	ExprNode* operand (size_t i) const
 	{
-		delete left_;
-		delete right_;
+		return (i == 0) ? left_ : (i == 1) ? right_ : nullptr;
 	}
 };
 
@@ -110,9 +183,9 @@ protected:
 
 public:
 	UnarNode(ExprNode* node) : next_(node) {}
-	~UnarNode ()
+	ExprNode* operand (size_t i) const
 	{
-		delete next_;
+		return (i == 0) ? next_ : nullptr;
 	}
 };
 
@@ -122,9 +195,9 @@ class NegNode : public UnarNode // 
 {
 public:
 	NegNode(ExprNode* node) : UnarNode(node) {}
-	bool calc (AVLTree<VarValue>& workspace) const
+	char symbol () const
 	{
-		return !next_->calc(workspace);
+		return '~';
 	}
 };
 
@@ -134,9 +207,9 @@ class ConjNode : public BinNode // 
 {
 public:
 	ConjNode(ExprNode* L, ExprNode* R) : BinNode(L, R) {}
-	bool calc (AVLTree<VarValue>& workspace) const
+	char symbol () const
 	{
-		return left_->calc(workspace) && right_->calc(workspace);
+		return '&';
 	}
 };
 
@@ -146,9 +219,9 @@ class DisNode : public BinNode // 
 {
 public:
 	DisNode (ExprNode* L, ExprNode* R) : BinNode (L, R) {}
-	bool calc (AVLTree<VarValue>& workspace) const
+	char symbol () const
 	{
-		return left_->calc (workspace) || right_->calc (workspace);
+		return 'v';
 	}
 };
 
@@ -158,9 +231,9 @@ class AddNode : public BinNode // 
 {
 public:
 	AddNode (ExprNode* L, ExprNode* R) : BinNode (L, R) {}
-	bool calc (AVLTree<VarValue>& workspace) const
+	char symbol () const
 	{
-		return left_->calc (workspace) != right_->calc (workspace);
+		return '+';
 	}
 };
 
@@ -170,9 +243,9 @@ class ImplNode : public BinNode // 
 {
 public:
 	ImplNode (ExprNode* L, ExprNode* R) : BinNode (L, R) {}
-	bool calc (AVLTree<VarValue>& workspace) const
+	char symbol () const
 	{
-		return left_->calc (workspace) <= right_->calc (workspace);
+		return '>';
 	}
 };
 
@@ -182,9 +255,9 @@ class InvNode : public BinNode // 
 {
 public:
 	InvNode (ExprNode* L, ExprNode* R) : BinNode (L, R) {}
-	bool calc (AVLTree<VarValue>& workspace) const
+	char symbol () const
 	{
-		return left_->calc (workspace) >= right_->calc (workspace);
+		return '<';
 	}
 };
 
@@ -194,9 +267,9 @@ class EquNode : public BinNode // 
 {
 public:
 	EquNode (ExprNode* L, ExprNode* R) : BinNode (L, R) {}
-	bool calc (AVLTree<VarValue>& workspace) const
+	char symbol () const
 	{
-		return left_->calc (workspace) == right_->calc (workspace);
+		return '=';
 	}
 };
 
@@ -206,9 +279,9 @@ class SheffNode : public BinNode // 
 {
 public:
 	SheffNode (ExprNode* L, ExprNode* R) : BinNode (L, R) {}
-	bool calc (AVLTree<VarValue>& workspace) const
+	char symbol () const
 	{
-		return !(left_->calc (workspace) && right_->calc (workspace));
+		return '|';
 	}
 };
 
@@ -218,9 +291,9 @@ class PierNode : public BinNode // 
 {
 public:
 	PierNode (ExprNode* L, ExprNode* R) : BinNode (L, R) {}
-	bool calc (AVLTree<VarValue>& workspace) const
+	char symbol () const
 	{
-		return !(left_->calc (workspace) || right_->calc (workspace));
+		return '^';
 	}
 };
 
@@ -0,0 +1,105 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include "corpus.h"
+
+void help ()
+{
+	std::cout << "Use \ngencorpus [-options] [destination_file_name]\n";
+	std::cout << "-n N \t number of lines (default 1000)\n";
+	std::cout << "-v N \t variables x1..xN (default 8)\n";
+	std::cout << "-d N \t maximum expression depth (default 6)\n";
+	std::cout << "-s P \t share of subexpressions repeating earlier ones in the line, 0..1 (default 0)\n";
+	std::cout << "-seed N \t random seed (default 1)\n";
+	std::cout << "Without a file name the expressions are written to standard output.\n";
+}
+
+int main (int argc, char* argv[])
+{
+	CorpusOptions options;
+	unsigned long long lines = 1000;
+	const char* path = nullptr;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		if (strcmp (argv[i], "-h") == 0 || strcmp (argv[i], "?") == 0)
+		{
+			help ();
+			return 0;
+		}
+
+		if (argv[i][0] != '-')
+		{
+			path = argv[i];
+			continue;
+		}
+
+		if (i + 1 == argc)
+		{
+			help ();
+			return 1;
+		}
+
+		const char* value = argv[++i];
+		if (strcmp (argv[i - 1], "-n") == 0)
+		{
+			lines = strtoull (value, nullptr, 10);
+		} else if (strcmp (argv[i - 1], "-v") == 0)
+		{
+			options.vars = strtoul (value, nullptr, 10);
+		} else if (strcmp (argv[i - 1], "-d") == 0)
+		{
+			options.depth = strtoul (value, nullptr, 10);
+		} else if (strcmp (argv[i - 1], "-s") == 0)
+		{
+			options.sharing = strtod (value, nullptr);
+		} else if (strcmp (argv[i - 1], "-seed") == 0)
+		{
+			options.seed = strtoull (value, nullptr, 10);
+		} else
+		{
+			help ();
+			return 1;
+		}
+	}
+
+	if (options.vars == 0 || options.sharing < 0 || options.sharing > 1)
+	{
+		help ();
+		return 1;
+	}
+
+	FILE* out = (path == nullptr) ? stdout : fopen (path, "wb");
+	if (out == nullptr)
+	{
+		return 3;
+	}
+
+	// Строки собираются в буфере и записываются блоками.
+	const size_t FlushSize = 1 << 20;
+	CorpusGenerator generator (options);
+	std::string buffer;
+	buffer.reserve (2 * FlushSize);
+
+	for (unsigned long long i = 0; i < lines; ++i)
+	{
+		generator.line (buffer);
+		buffer += '\n';
+
+		if (buffer.size () >= FlushSize)
+		{
+			fwrite (buffer.data (), 1, buffer.size (), out);
+			buffer.clear ();
+		}
+	}
+
+	fwrite (buffer.data (), 1, buffer.size (), out);
+	if (out != stdout)
+	{
+		fclose (out);
+	}
+
+	return 0;
+}
@@ -0,0 +1,115 @@
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "linereader.h"
+
+LineReader::LineReader (const char* path) : fd_ (-1), data_ (nullptr), size_ (0), pos_ (0), mapped_ (false), eof_ (false)
+{
+	fd_ = open (path, O_RDONLY);
+	if (fd_ < 0)
+	{
+		return;
+	}
+
+	struct stat info;
+	if (fstat (fd_, &info) == 0 && S_ISREG (info.st_mode))
+	{
+		if (info.st_size == 0)
+		{
+			eof_ = true;
+			return;
+		}
+
+		void* map = mmap (nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd_, 0);
+		if (map != MAP_FAILED)
+		{
+			madvise (map, info.st_size, MADV_SEQUENTIAL);
+			data_ = static_cast<const char*> (map);
+			size_ = info.st_size;
+			mapped_ = true;
+			eof_ = true;
+		}
+	}
+}
+
+bool LineReader::fill ()
+{
+	size_t left = size_ - pos_;
+	if (pos_ > 0)
+	{
+		memmove (buffer_.data (), buffer_.data () + pos_, left);
+		pos_ = 0;
+		size_ = left;
+	}
+
+	if (buffer_.size () - size_ < ChunkSize)
+	{
+		buffer_.resize (size_ + ChunkSize);
+	}
+
+	ssize_t n = read (fd_, buffer_.data () + size_, buffer_.size () - size_);
+	data_ = buffer_.data ();
+
+	if (n <= 0)
+	{
+		eof_ = true;
+		return false;
+	}
+
+	size_ += n;
+	return true;
+}
+
+bool LineReader::next (std::string_view& line)
+{
+	if (fd_ < 0)
+	{
+		return false;
+	}
+
+	size_t scanned = 0; // часть строки, в которой уже искали '\n'.
+	for (;;)
+	{
+		const char* end = nullptr;
+		if (pos_ + scanned < size_)
+		{
+			end = static_cast<const char*> (memchr (data_ + pos_ + scanned, '\n', size_ - pos_ - scanned));
+		}
+
+		if (end != nullptr)
+		{
+			line = std::string_view (data_ + pos_, end - data_ - pos_);
+			pos_ = end - data_ + 1;
+			return true;
+		}
+
+		scanned = size_ - pos_;
+		if (eof_ || !fill ())
+		{
+			break;
+		}
+	}
+
+	if (pos_ == size_)
+	{
+		return false;
+	}
+
+	line = std::string_view (data_ + pos_, size_ - pos_);
+	pos_ = size_;
+	return true;
+}
+
+LineReader::~LineReader ()
+{
+	if (mapped_)
+	{
+		munmap (const_cast<char*> (data_), size_);
+	}
+	if (fd_ >= 0)
+	{
+		close (fd_);
+	}
+}
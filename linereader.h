@@ -0,0 +1,43 @@
+#ifndef LineReader_
+#define LineReader_
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+// Построчное чтение файла без копирования строк.
+// Обычный файл отображается в память целиком, остальные (каналы,
+// устройства) читаются блоками в растущий буфер.
+// Строка, возвращённая next, действительна до следующего вызова next.
+class LineReader
+{
+	int fd_;
+	const char* data_; // отображённый файл или начало буфера.
+	size_t size_;
+	size_t pos_;
+	bool mapped_;
+	bool eof_;
+
+	std::vector<char> buffer_;
+
+	static constexpr size_t ChunkSize = 1 << 20;
+
+	bool fill ();
+
+public:
+	explicit LineReader (const char* path);
+	LineReader (const LineReader&) = delete;
+	LineReader& operator=(const LineReader&) = delete;
+
+	bool is_open () const
+	{
+		return fd_ >= 0;
+	}
+
+	// Следующая строка без символа '\n'. false, если строк больше нет.
+	bool next (std::string_view& line);
+
+	~LineReader ();
+};
+
+#endif // LineReader_
@@ -0,0 +1,185 @@
+#ifndef NodeFactory_
+#define NodeFactory_
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+#include "arena.h"
+#include "exprnodes.h"
+#include "simplify.h"
+
+// Создаёт узлы выражения в Arena. Структурно равные узлы (та же операция
+// над теми же операндами) создаются один раз, поэтому повторяющиеся
+// подвыражения разделяются и дерево разбора становится DAG.
+// Операции упрощаются при создании (см. simplify.h), так что DAG сразу
+// строится упрощённым, без второго прохода.
+// Узлы нумеруются подряд с нуля (ExprNode::index), так что проходы по
+// DAG хранят сведения об узлах в массивах размером size ().
+class NodeFactory
+{
+	struct Entry
+	{
+		char symbol;
+		size_t slot; // номер переменной для 'x'.
+		const ExprNode* left;
+		const ExprNode* right;
+		ExprNode* node; // nullptr - пустая ячейка.
+	};
+
+	Arena& nodes_;
+	std::vector<Entry> table_; // открытая адресация, размер - степень двойки.
+	size_t size_;
+	size_t simplified_; // операции, заменённые упрощением.
+
+	static constexpr size_t InitialSize = 64;
+
+	static size_t hash (char symbol, size_t slot, const ExprNode* left, const ExprNode* right)
+	{
+		size_t h = reinterpret_cast<size_t> (left) * 0x9E3779B97F4A7C15ULL;
+		h ^= reinterpret_cast<size_t> (right) * 0xC2B2AE3D27D4EB4FULL;
+		h ^= (slot * 131 + symbol) * 0x165667B19E3779F9ULL;
+		return h ^ (h >> 32);
+	}
+
+	ExprNode* create (char symbol, size_t slot, ExprNode* left, ExprNode* right)
+	{
+		switch (symbol)
+		{
+		case '0':
+			return nodes_.make<NumNode> (false);
+		case '1':
+			return nodes_.make<NumNode> (true);
+		case 'x':
+			return nodes_.make<VarNode> (slot);
+		case '~':
+			return nodes_.make<NegNode> (left);
+		case '&':
+			return nodes_.make<ConjNode> (left, right);
+		case 'v':
+			return nodes_.make<DisNode> (left, right);
+		case '+':
+			return nodes_.make<AddNode> (left, right);
+		case '>':
+			return nodes_.make<ImplNode> (left, right);
+		case '<':
+			return nodes_.make<InvNode> (left, right);
+		case '=':
+			return nodes_.make<EquNode> (left, right);
+		case '|':
+			return nodes_.make<SheffNode> (left, right);
+		case '^':
+			return nodes_.make<PierNode> (left, right);
+		default:
+			throw "error";
+		}
+	}
+
+	void grow ()
+	{
+		std::vector<Entry> old (2 * table_.size (), Entry {});
+		old.swap (table_);
+
+		size_t mask = table_.size () - 1;
+		for (const Entry& entry : old)
+		{
+			if (entry.node != nullptr)
+			{
+				size_t i = hash (entry.symbol, entry.slot, entry.left, entry.right) & mask;
+				while (table_[i].node != nullptr)
+				{
+					i = (i + 1) & mask;
+				}
+				table_[i] = entry;
+			}
+		}
+	}
+
+	ExprNode* get (char symbol, size_t slot, ExprNode* left, ExprNode* right)
+	{
+		size_t mask = table_.size () - 1;
+		size_t i = hash (symbol, slot, left, right) & mask;
+		for (; table_[i].node != nullptr; i = (i + 1) & mask)
+		{
+			const Entry& entry = table_[i];
+			if (entry.symbol == symbol && entry.slot == slot && entry.left == left && entry.right == right)
+			{
+				return entry.node;
+			}
+		}
+
+		ExprNode* node = create (symbol, slot, left, right);
+		node->set_index (size_++);
+		table_[i] = Entry {symbol, slot, left, right, node};
+
+		if (2 * size_ > table_.size ())
+		{
+			grow ();
+		}
+
+		return node;
+	}
+
+public:
+	NodeFactory (Arena& nodes) : nodes_ (nodes), table_ (InitialSize, Entry {}), size_ (0), simplified_ (0)
+	{}
+
+	ExprNode* number (bool x)
+	{
+		return get (x ? '1' : '0', 0, nullptr, nullptr);
+	}
+	ExprNode* var (size_t slot)
+	{
+		return get ('x', slot, nullptr, nullptr);
+	}
+	// Операция symbol ('~', '&', 'v', ...); у отрицания right не задаётся.
+	ExprNode* make (char symbol, ExprNode* left, ExprNode* right = nullptr)
+	{
+		if (ExprNode* node = simplify (symbol, left, right, *this))
+		{
+			++simplified_;
+			return node;
+		}
+
+		return get (symbol, 0, left, right);
+	}
+
+	// Количество различных созданных узлов.
+	size_t size () const
+	{
+		return size_;
+	}
+	// Сколько вызовов make упрощение заменило более простым узлом.
+	size_t simplified () const
+	{
+		return simplified_;
+	}
+};
+
+// Вызывает visit (node) для каждого узла DAG root один раз, после всех его
+// операндов. count - число узлов фабрики, создавшей root.
+// Обход без рекурсии, глубина выражения не ограничена стеком вызовов.
+template <typename Visit>
+void post_order (const ExprNode* root, size_t count, Visit visit)
+{
+	std::vector<char> seen (count, 0);
+	std::vector<std::pair<const ExprNode*, size_t>> stack; // узел и номер следующего операнда.
+	stack.emplace_back (root, 0);
+	seen[root->index ()] = 1;
+
+	while (!stack.empty ())
+	{
+		const ExprNode* node = stack.back ().first;
+		const ExprNode* next = node->operand (stack.back ().second++);
+		if (next == nullptr)
+		{
+			stack.pop_back ();
+			visit (node);
+		} else if (!seen[next->index ()])
+		{
+			seen[next->index ()] = 1;
+			stack.emplace_back (next, 0);
+		}
+	}
+}
+
+#endif // NodeFactory_
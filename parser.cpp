@@ -0,0 +1,205 @@
+#include "parser.h"
+
+// Сила связывания бинарной операции, 0 - не бинарная операция.
+static int binding_power (char token)
+{
+	switch (token)
+	{
+	case '&':
+		return 5;
+	case 'v':
+	case '+':
+		return 4;
+	case '>':
+	case '<':
+		return 3;
+	case '=':
+		return 2;
+	case '|':
+	case '^':
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+void ExprParser::next ()
+{
+	while (pos_ < end_ && (*pos_ == ' ' || *pos_ == '\t' || *pos_ == '\r'))
+	{
+		++pos_;
+	}
+
+	if (pos_ == end_)
+	{
+		token_ = '\0';
+		*out_ = '\0';
+		return;
+	}
+
+	char ch = *pos_++;
+	switch (ch)
+	{
+	case 'x':
+	{
+		uint64_t num = 0;
+		const char* digits = pos_;
+		while (pos_ < end_ && *pos_ >= '0' && *pos_ <= '9')
+		{
+			num = num * 10 + (*pos_++ - '0');
+			if (num > UINT32_MAX)
+			{
+				throw "error";
+			}
+		}
+
+		if (pos_ == digits || num == 0)
+		{
+			throw "error";
+		}
+
+		token_ = 'x';
+		name_ = num;
+		write_var (out_, num);
+		out_ += VarTokenSize;
+		return;
+	}
+	case '0':
+	case '1':
+	case '(':
+	case ')':
+	case '~':
+	case '&':
+	case 'v':
+	case '+':
+	case '>':
+	case '<':
+	case '=':
+	case '|':
+	case '^':
+		token_ = ch;
+		*out_++ = ch;
+		return;
+	default:
+		throw "error";
+	}
+}
+
+// Константа или переменная.
+ExprNode* ExprParser::atom ()
+{
+	switch (token_)
+	{
+	case '0':
+	case '1':
+		return factory_.number (token_ == '1');
+	case 'x':
+	{
+		uint32_t id = vars_.intern (name_);
+		if (id == var_nodes_.size ())
+		{
+			var_nodes_.push_back (static_cast<VarNode*> (factory_.var (id)));
+		}
+		return var_nodes_[id];
+	}
+	default:
+		throw "error";
+	}
+}
+
+// Применяет бинарную операцию с вершины стека к двум верхним операндам.
+void ExprParser::reduce ()
+{
+	ExprNode* right = operands_.back ();
+	operands_.pop_back ();
+	operands_.back () = factory_.make (operators_.back (), operands_.back (), right);
+	operators_.pop_back ();
+}
+
+// Отрицания перед операндом связывают сильнее любой бинарной операции.
+void ExprParser::push_operand (ExprNode* node)
+{
+	while (!operators_.empty () && operators_.back () == '~')
+	{
+		node = factory_.make ('~', node);
+		operators_.pop_back ();
+	}
+
+	operands_.push_back (node);
+}
+
+ExprNode* ExprParser::parse ()
+{
+	next ();
+
+	for (;;)
+	{
+		// Операнд: отрицания и открывающие скобки, затем константа или переменная.
+		while (token_ == '~' || token_ == '(')
+		{
+			operators_.push_back (token_);
+			next ();
+		}
+		push_operand (atom ());
+		next ();
+
+		// Закрывающие скобки завершают операнды, бинарная операция ждёт следующий.
+		while (token_ == ')')
+		{
+			while (!operators_.empty () && operators_.back () != '(')
+			{
+				reduce ();
+			}
+			if (operators_.empty ())
+			{
+				throw "error";
+			}
+
+			operators_.pop_back ();
+			ExprNode* node = operands_.back ();
+			operands_.pop_back ();
+			push_operand (node);
+			next ();
+		}
+
+		int power = binding_power (token_);
+		if (power == 0)
+		{
+			break;
+		}
+
+		while (!operators_.empty () && binding_power (operators_.back ()) >= power)
+		{
+			reduce ();
+		}
+		operators_.push_back (token_);
+		next ();
+	}
+
+	if (token_ != '\0')
+	{
+		throw "error";
+	}
+
+	while (!operators_.empty ())
+	{
+		if (operators_.back () == '(')
+		{
+			throw "error";
+		}
+		reduce ();
+	}
+
+	return operands_.back ();
+}
+
+std::vector<uint32_t> ExprParser::variables ()
+{
+	std::vector<uint32_t> renumber = vars_.sort ();
+	for (size_t id = 0; id < var_nodes_.size (); ++id)
+	{
+		var_nodes_[id]->bind (renumber[id]);
+	}
+
+	return vars_.names ();
+}
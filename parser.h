@@ -0,0 +1,50 @@
+#ifndef Parser_
+#define Parser_
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "exprnodes.h"
+#include "nodefactory.h"
+#include "vartable.h"
+
+// Разбор выражения за один проход: лексемы читаются прямо из входной
+// строки, узлы создаются через factory по алгоритму сортировочной станции
+// с явными стеками операндов и операций, так что вложенность скобок и
+// отрицаний не ограничена стеком вызовов.
+// Приоритеты по убыванию: ~, &, v и +, > и <, =, | и ^; бинарные
+// операции левоассоциативны.
+// Попутно в out записывается нормализованная запись без пробелов,
+// переменные - лексемами VarTokenSize байт (см. vartable.h).
+class ExprParser
+{
+	const char* pos_;
+	const char* end_;
+	char* out_;
+	NodeFactory& factory_;
+	VarTable vars_;
+	std::vector<VarNode*> var_nodes_; // узел переменной по плотному номеру.
+	char token_; // текущая лексема: знак операции, '(', ')', '0', '1', 'x' или '\0' в конце.
+	uint32_t name_; // номер переменной для 'x'.
+	std::vector<ExprNode*> operands_;
+	std::vector<char> operators_; // бинарные операции, '~' и '('.
+
+	void next ();
+	ExprNode* atom ();
+	void reduce ();
+	void push_operand (ExprNode*);
+
+public:
+	// out должен вмещать 3 * text.size () + 1 байт.
+	ExprParser (std::string_view text, char* out, NodeFactory& factory)
+		: pos_ (text.data ()), end_ (text.data () + text.size ()), out_ (out), factory_ (factory), token_ ('\0'), name_ (0)
+	{}
+
+	// Корень DAG; при синтаксической ошибке исключение "error".
+	ExprNode* parse ();
+	// Нумерует переменные по возрастанию номеров и возвращает номера.
+	// Вызывается после parse, узлы переменных перенумеровываются на месте.
+	std::vector<uint32_t> variables ();
+};
+
+#endif // Parser_
@@ -0,0 +1,108 @@
+#include <cstring>
+#include "program.h"
+#include "bitops.h"
+
+void Program::emit (OpCode op, unsigned arg)
+{
+	switch (op)
+	{
+	case OpCode::Load:
+		if (arg >= registers_)
+		{
+			throw "error";
+		}
+		[[fallthrough]];
+	case OpCode::Zero:
+	case OpCode::One:
+	case OpCode::Var:
+		++top_;
+		break;
+	case OpCode::Store:
+		if (arg >= registers_)
+		{
+			registers_ = arg + 1;
+		}
+		[[fallthrough]];
+	case OpCode::Neg:
+		if (top_ < 1)
+		{
+			throw "error";
+		}
+		break;
+	default:
+		if (top_ < 2)
+		{
+			throw "error";
+		}
+		--top_;
+	}
+
+	if (top_ > depth_)
+	{
+		depth_ = top_;
+	}
+
+	code_.push_back ({ op, arg });
+}
+
+void Program::calc (uint64_t* out, BitWorkspace& workspace) const
+{
+	std::vector<uint64_t*> stack (depth_);
+	if (depth_ > 0)
+	{
+		stack[0] = out;
+	}
+	for (size_t i = 1; i < depth_; ++i)
+	{
+		stack[i] = workspace.alloc ();
+	}
+
+	std::vector<uint64_t*> registers (registers_);
+	for (size_t i = 0; i < registers_; ++i)
+	{
+		registers[i] = workspace.alloc ();
+	}
+
+	size_t n = workspace.count ();
+	size_t top = 0;
+
+	for (const Instruction& cmd : code_)
+	{
+		switch (cmd.op)
+		{
+		case OpCode::Zero:
+		case OpCode::One:
+		{
+			uint64_t word = (cmd.op == OpCode::One) ? ~0ULL : 0;
+			uint64_t* dst = stack[top++];
+			for (size_t i = 0; i < n; ++i)
+			{
+				dst[i] = word;
+			}
+			break;
+		}
+		case OpCode::Var:
+			workspace.load (stack[top++], cmd.arg);
+			break;
+		case OpCode::Neg:
+			bit_apply (BitOp::Neg, stack[top - 1], nullptr, n);
+			break;
+		case OpCode::Load:
+			memcpy (stack[top++], registers[cmd.arg], n * sizeof (uint64_t));
+			break;
+		case OpCode::Store:
+			memcpy (registers[cmd.arg], stack[top - 1], n * sizeof (uint64_t));
+			break;
+		default:
+			// Порядок OpCode::Neg..Pier совпадает с BitOp.
+			--top;
+			bit_apply (static_cast<BitOp> (static_cast<int> (cmd.op) - static_cast<int> (OpCode::Neg)),
+			           stack[top - 1], stack[top], n);
+		}
+	}
+
+	for (size_t i = 1; i < depth_ + registers_; ++i)
+	{
+		workspace.release ();
+	}
+}
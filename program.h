@@ -0,0 +1,78 @@
+#ifndef Program_
+#define Program_
+
+#include <cstdint>
+#include <vector>
+#include "exprnodes.h"
+
+// Команды стековой машины. Бинарные операции снимают два верхних
+// операнда и кладут результат, Neg заменяет верхний операнд.
+enum class OpCode : unsigned char
+{
+	Zero,
+	One,
+	Var, // arg - номер переменной (см. BooleanExpression::Compiled::vars).
+	Neg,
+	Conj,
+	Dis,
+	Add,
+	Impl,
+	Inv,
+	Equ,
+	Sheff,
+	Pier,
+	Load, // кладёт копию регистра arg.
+	Store // копирует верхний операнд в регистр arg, не снимая его.
+};
+
+struct Instruction
+{
+	OpCode op;
+	unsigned arg;
+};
+
+// Выражение в виде линейной программы для стековой машины.
+class Program
+{
+	std::vector<Instruction> code_;
+	size_t depth_; // наибольшая глубина стека.
+	size_t top_;
+	size_t registers_;
+
+public:
+	Program () : depth_ (0), top_ (0), registers_ (0)
+	{}
+
+	void emit (OpCode, unsigned = 0);
+	void reserve (size_t size)
+	{
+		code_.reserve (size);
+	}
+
+	size_t size () const
+	{
+		return code_.size ();
+	}
+	size_t depth () const
+	{
+		return depth_;
+	}
+	size_t registers () const
+	{
+		return registers_;
+	}
+	const Instruction& operator[](size_t i) const
+	{
+		return code_[i];
+	}
+
+	// Корректная программа оставляет на стеке ровно один операнд.
+	bool complete () const
+	{
+		return top_ == 1;
+	}
+
+	void calc (uint64_t* out, BitWorkspace& workspace) const;
+};
+
+#endif // Program_
@@ -0,0 +1,135 @@
+#include <vector>
+#include "bitops.h"
+#include "nodefactory.h"
+#include "simplify.h"
+
+static bool is_constant (const ExprNode* node)
+{
+	return node->symbol () == '0' || node->symbol () == '1';
+}
+
+// Упрощённое отрицание node или nullptr, если упрощать нечего.
+static ExprNode* negation (ExprNode* node, NodeFactory& factory)
+{
+	if (node->symbol () == '~')
+	{
+		return node->operand (0);
+	}
+	if (is_constant (node))
+	{
+		return factory.number (node->symbol () == '0');
+	}
+
+	return nullptr;
+}
+
+static ExprNode* negate (ExprNode* node, NodeFactory& factory)
+{
+	ExprNode* result = negation (node, factory);
+	return (result != nullptr) ? result : factory.make ('~', node);
+}
+
+// Функция одного операнда x, принимающая значения t0 при x = 0 и t1 при x = 1.
+static ExprNode* unary (unsigned t0, unsigned t1, ExprNode* x, NodeFactory& factory)
+{
+	if (t0 == t1)
+	{
+		return factory.number (t0);
+	}
+
+	return t1 ? x : negate (x, factory);
+}
+
+static bool is_negation (const ExprNode* a, const ExprNode* b)
+{
+	return (a->symbol () == '~' && a->operand (0) == b) || (b->symbol () == '~' && b->operand (0) == a);
+}
+
+// Если node = x op y или y op x, возвращает y.
+static ExprNode* other_operand (const ExprNode* node, char op, const ExprNode* x)
+{
+	if (node->symbol () != op)
+	{
+		return nullptr;
+	}
+	if (node->operand (0) == x)
+	{
+		return node->operand (1);
+	}
+	if (node->operand (1) == x)
+	{
+		return node->operand (0);
+	}
+
+	return nullptr;
+}
+
+static ExprNode* binary (char symbol, ExprNode* a, ExprNode* b, NodeFactory& factory)
+{
+	unsigned code = bit_op_code (bit_op (symbol));
+	auto bit = [code] (unsigned i) { return (code >> i) & 1; };
+
+	if (is_constant (a) && is_constant (b))
+	{
+		return factory.number (bit ((a->symbol () == '1') << 1 | (b->symbol () == '1')));
+	}
+	if (is_constant (a))
+	{
+		unsigned x = (a->symbol () == '1') << 1;
+		return unary (bit (x), bit (x | 1), b, factory);
+	}
+	if (is_constant (b))
+	{
+		unsigned y = (b->symbol () == '1');
+		return unary (bit (y), bit (2 | y), a, factory);
+	}
+	if (a == b)
+	{
+		return unary (bit (0), bit (3), a, factory);
+	}
+	if (is_negation (a, b))
+	{
+		return unary (bit (1), bit (2), a, factory);
+	}
+
+	if (symbol == '&' && other_operand (b, 'v', a) != nullptr)
+	{
+		return a;
+	}
+	if (symbol == '&' && other_operand (a, 'v', b) != nullptr)
+	{
+		return b;
+	}
+	if (symbol == 'v' && other_operand (b, '&', a) != nullptr)
+	{
+		return a;
+	}
+	if (symbol == 'v' && other_operand (a, '&', b) != nullptr)
+	{
+		return b;
+	}
+
+	if (symbol == '+')
+	{
+		if (ExprNode* rest = other_operand (b, '+', a))
+		{
+			return rest;
+		}
+		if (ExprNode* rest = other_operand (a, '+', b))
+		{
+			return rest;
+		}
+	}
+
+	return nullptr;
+}
+
+ExprNode* simplify (char symbol, ExprNode* left, ExprNode* right, NodeFactory& factory)
+{
+	if (symbol == '~')
+	{
+		return negation (left, factory);
+	}
+
+	return binary (symbol, left, right, factory);
+}
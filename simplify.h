@@ -0,0 +1,16 @@
+#ifndef Simplify_
+#define Simplify_
+
+#include "exprnodes.h"
+
+class NodeFactory;
+
+// Упрощение операции symbol над уже упрощёнными операндами left и right
+// (у отрицания right не задаётся): свёртка констант (x & 0, 1 > x),
+// снятие двойного отрицания, идемпотентность (x v x), x op ~x,
+// поглощение (x & (x v y)) и сокращение при сложении (x + (x + y)).
+// Возвращает равносильный узел, построенный через factory, или nullptr,
+// если ни одно правило не подходит. Вызывается из NodeFactory::make.
+ExprNode* simplify (char symbol, ExprNode* left, ExprNode* right, NodeFactory& factory);
+
+#endif // Simplify_
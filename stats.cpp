@@ -0,0 +1,110 @@
+#include <atomic>
+#include <cstdlib>
+#include <iomanip>
+#include <new>
+#include "stats.h"
+
+static std::atomic<uint64_t> calls_[size_t (Phase::Count)];
+static std::atomic<uint64_t> ns_[size_t (Phase::Count)];
+static std::atomic<uint64_t> counters_[size_t (Counter::Count)];
+
+void stats_add (Counter c, uint64_t n)
+{
+	counters_[size_t (c)].fetch_add (n, std::memory_order_relaxed);
+}
+
+void stats_phase (Phase phase, uint64_t ns)
+{
+	calls_[size_t (phase)].fetch_add (1, std::memory_order_relaxed);
+	ns_[size_t (phase)].fetch_add (ns, std::memory_order_relaxed);
+}
+
+#ifdef BOOLCALC_STATS
+// Замена глобальных operator new и delete: считаются все выделения памяти
+// (узлы, строки, векторы, таблицы), а не только блоки Arena.
+// operator new[] и варианты с nothrow по умолчанию вызывают эти.
+void* operator new (size_t size)
+{
+	stats_add (Counter::Allocations, 1);
+	stats_add (Counter::AllocatedBytes, size);
+
+	void* result = malloc ((size == 0) ? 1 : size);
+	if (result == nullptr)
+	{
+		throw std::bad_alloc ();
+	}
+	return result;
+}
+
+void operator delete (void* p) noexcept
+{
+	free (p);
+}
+
+void operator delete (void* p, size_t) noexcept
+{
+	free (p);
+}
+#endif
+
+Stats stats ()
+{
+	Stats result;
+	for (size_t i = 0; i < size_t (Phase::Count); ++i)
+	{
+		result.calls[i] = calls_[i].load (std::memory_order_relaxed);
+		result.ns[i] = ns_[i].load (std::memory_order_relaxed);
+	}
+	for (size_t i = 0; i < size_t (Counter::Count); ++i)
+	{
+		result.counters[i] = counters_[i].load (std::memory_order_relaxed);
+	}
+
+	return result;
+}
+
+void reset_stats ()
+{
+	for (size_t i = 0; i < size_t (Phase::Count); ++i)
+	{
+		calls_[i].store (0, std::memory_order_relaxed);
+		ns_[i].store (0, std::memory_order_relaxed);
+	}
+	for (size_t i = 0; i < size_t (Counter::Count); ++i)
+	{
+		counters_[i].store (0, std::memory_order_relaxed);
+	}
+}
+
+const char* phase_name (Phase phase)
+{
+	const char* names[] = { "parse", "compile", "table", "zhegalkin", "classify" };
+	return names[size_t (phase)];
+}
+
+const char* counter_name (Counter c)
+{
+	const char* names[] = { "expressions", "nodes", "removed nodes", "variables", "allocations", "allocated bytes", "rows" };
+	return names[size_t (c)];
+}
+
+void print_stats (std::ostream& out)
+{
+	if (!StatsEnabled)
+	{
+		out << "statistics are not collected: build with STATS=1\n";
+		return;
+	}
+
+	Stats s = stats ();
+	out << std::left << std::setw (16) << "phase" << std::right << std::setw (12) << "calls" << std::setw (16) << "total ns" << std::setw (12) << "avg ns" << "\n";
+	for (size_t i = 0; i < size_t (Phase::Count); ++i)
+	{
+		uint64_t avg = (s.calls[i] == 0) ? 0 : s.ns[i] / s.calls[i];
+		out << std::left << std::setw (16) << phase_name (Phase (i)) << std::right << std::setw (12) << s.calls[i] << std::setw (16) << s.ns[i] << std::setw (12) << avg << "\n";
+	}
+	for (size_t i = 0; i < size_t (Counter::Count); ++i)
+	{
+		out << std::left << std::setw (16) << counter_name (Counter (i)) << std::right << std::setw (12) << s.counters[i] << "\n";
+	}
+}
@@ -0,0 +1,90 @@
+#ifndef Stats_
+#define Stats_
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+// Счётчики и время этапов обработки выражений для поиска медленных мест.
+// Собираются, только если программа собрана с -DBOOLCALC_STATS
+// (make STATS=1); иначе макросы STATS_* пустые и ничего не стоят.
+// Счётчики общие для всех потоков.
+
+enum class Phase
+{
+	Parse, // разбор строки с упрощением и нумерация переменных.
+	Compile, // построение программы для стековой машины.
+	Table, // вычисление таблицы истинности.
+	Zhegalkin, // вместе с построением таблицы.
+	Classify, // классы Поста.
+	Count
+};
+
+enum class Counter
+{
+	Expressions, // построенные выражения.
+	Nodes, // узлы DAG после разбора.
+	RemovedNodes, // операции, заменённые упрощением.
+	Vars,
+	Allocations, // все вызовы operator new, в том числе из контейнеров.
+	AllocatedBytes,
+	Rows, // вычисленные строки таблиц.
+	Count
+};
+
+struct Stats
+{
+	uint64_t calls[size_t (Phase::Count)];
+	uint64_t ns[size_t (Phase::Count)];
+	uint64_t counters[size_t (Counter::Count)];
+
+	uint64_t operator[](Counter c) const
+	{
+		return counters[size_t (c)];
+	}
+};
+
+#ifdef BOOLCALC_STATS
+constexpr bool StatsEnabled = true;
+#else
+constexpr bool StatsEnabled = false;
+#endif
+
+// Текущие значения; без BOOLCALC_STATS - нули.
+Stats stats ();
+void reset_stats ();
+void print_stats (std::ostream&);
+const char* phase_name (Phase);
+const char* counter_name (Counter);
+
+void stats_add (Counter, uint64_t);
+void stats_phase (Phase, uint64_t ns);
+
+// Время от создания до уничтожения относится к этапу phase.
+class PhaseTimer
+{
+	Phase phase_;
+	std::chrono::steady_clock::time_point start_;
+
+public:
+	explicit PhaseTimer (Phase phase) : phase_ (phase), start_ (std::chrono::steady_clock::now ())
+	{}
+	PhaseTimer (const PhaseTimer&) = delete;
+	PhaseTimer& operator=(const PhaseTimer&) = delete;
+
+	~PhaseTimer ()
+	{
+		auto ns = std::chrono::duration_cast<std::chrono::nanoseconds> (std::chrono::steady_clock::now () - start_);
+		stats_phase (phase_, ns.count ());
+	}
+};
+
+#ifdef BOOLCALC_STATS
+#define STATS_PHASE(phase) PhaseTimer stats_timer_ (Phase::phase)
+#define STATS_ADD(counter, n) stats_add (Counter::counter, (n))
+#else
+#define STATS_PHASE(phase)
+#define STATS_ADD(counter, n)
+#endif
+
+#endif // Stats_
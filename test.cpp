@@ -1,7 +1,16 @@
 #include <string>
+#include <bit>
 #include <gtest/gtest.h>
 
 #include "boolexpr.h"
+#include "bdd.h"
+#include "AVLTree.h"
+#include "linereader.h"
+#include "batch.h"
+#include "corpus.h"
+#include "stats.h"
+#include <sstream>
+#include <thread>
 
 TEST (Create, default_constructor)
 {
@@ -49,6 +58,38 @@ TEST (Create, move_constructor)
 	EXPECT_EQ ("1", y);
 }
 
+TEST (Create, move_assignment)
+{
+	BooleanExpression x = "x1 & x2";
+	BooleanExpression y;
+	y = std::move (x);
+
+	EXPECT_EQ ("x1 & x2", std::string (y));
+	EXPECT_EQ ("", std::string (x));
+	EXPECT_EQ ("0", x.table ());
+	EXPECT_EQ (0, x.node_count ());
+
+	x = y;
+	EXPECT_EQ (x, y);
+	EXPECT_EQ ("0001", x.table ());
+}
+
+TEST (Create, copy_outlives_source)
+{
+	std::vector<BooleanExpression> copies;
+	{
+		BooleanExpression x = "(x1 + x2) & (x1 + x2) v x3";
+		copies.assign (3, x);
+		x = "0";
+	}
+
+	for (const BooleanExpression& c : copies)
+	{
+		EXPECT_EQ ("01111101", c.table ());
+		EXPECT_EQ (c, copies[0]);
+	}
+}
+
 TEST (Create, Spaces)
 {
 	BooleanExpression a ("x1&x2");
@@ -69,12 +110,81 @@ TEST (Create, errors)
 	EXPECT_THROW (BooleanExpression ("a & b"), const char*);
 	EXPECT_THROW (BooleanExpression ("x1 $ x2"), const char*);
 	EXPECT_THROW (BooleanExpression ("~x"), const char*);
-	EXPECT_THROW (BooleanExpression ("x12345"), const char*);
+	EXPECT_THROW (BooleanExpression ("x0"), const char*);
+	EXPECT_THROW (BooleanExpression ("x4294967296"), const char*);
 	EXPECT_THROW (BooleanExpression ("(x1 & x2"), const char*);
 	EXPECT_THROW (BooleanExpression ("x1 & x2)"), const char*);
 	EXPECT_THROW (BooleanExpression ("x1x2"), const char*);
 	EXPECT_THROW (BooleanExpression ("x1 x2 & x3 x4"), const char*);
 	EXPECT_THROW (BooleanExpression ("{x1}"), const char*);
+	EXPECT_THROW (BooleanExpression ("x1~"), const char*);
+	EXPECT_THROW (BooleanExpression ("x4 x1 |"), const char*);
+	EXPECT_THROW (BooleanExpression ("& x1 x2"), const char*);
+	EXPECT_THROW (BooleanExpression ("()"), const char*);
+}
+
+TEST (Create, operator_precedence)
+{
+	EXPECT_EQ (BooleanExpression ("x1 v x2 & x3").table (), BooleanExpression ("x1 v (x2 & x3)").table ());
+	EXPECT_EQ (BooleanExpression ("x1 + x2 v x3").table (), BooleanExpression ("(x1 + x2) v x3").table ());
+	EXPECT_EQ (BooleanExpression ("x1 > x2 + x3").table (), BooleanExpression ("x1 > (x2 + x3)").table ());
+	EXPECT_EQ (BooleanExpression ("x1 = x2 < x3").table (), BooleanExpression ("x1 = (x2 < x3)").table ());
+	EXPECT_EQ (BooleanExpression ("x1 | x2 = x3").table (), BooleanExpression ("x1 | (x2 = x3)").table ());
+	EXPECT_EQ (BooleanExpression ("x1 > x2 > x3").table (), BooleanExpression ("(x1 > x2) > x3").table ());
+	EXPECT_EQ (BooleanExpression ("x1 ^ x2 | x3").table (), BooleanExpression ("(x1 ^ x2) | x3").table ());
+	EXPECT_EQ (BooleanExpression ("~x1 & x2").table (), BooleanExpression ("(~x1) & x2").table ());
+	EXPECT_EQ (BooleanExpression ("~~(x1)").table (), "01");
+
+	std::string deep = std::string (100000, '(') + "x1" + std::string (100000, ')');
+	EXPECT_EQ (BooleanExpression (deep).table (), "01");
+	EXPECT_THROW (BooleanExpression (deep + ")"), const char*);
+	EXPECT_THROW (BooleanExpression ("(" + deep), const char*);
+}
+
+TEST (Create, deep_expressions)
+{
+	// Проходы по DAG не рекурсивны: глубина 10^5 не переполняет стек.
+	std::string negations = std::string (100001, '~') + "x1";
+	BooleanExpression neg (negations);
+	EXPECT_EQ (neg.table (), "10");
+
+	std::string chain;
+	for (int i = 0; i < 100000; ++i)
+	{
+		chain += "x" + std::to_string (1 + i % 20) + ((i % 2) ? " > (" : " + (");
+	}
+	chain += "x1" + std::string (100000, ')');
+
+	BooleanExpression f (chain);
+	EXPECT_GT (f.node_count (), 1000u);
+	EXPECT_NO_THROW (f.classification ());
+	EXPECT_TRUE (f.equivalent (f));
+}
+
+TEST (Create, wide_variable_names)
+{
+	BooleanExpression f ("x10 & x200 v x4294967295");
+	EXPECT_EQ (std::string (f), "x10 & x200 v x4294967295");
+	EXPECT_EQ (f.table (), "01010111");
+	EXPECT_EQ (std::string (BooleanExpression ("x12 + x3").zhegalkin ()), "x12 + x3");
+	EXPECT_EQ (std::string (BooleanExpression (f)), std::string (f));
+
+	// 300 переменных: таблица не строится, классы и равносильность - по диаграмме.
+	std::string parity = "x1";
+	std::string reversed = "x300";
+	for (int i = 2; i <= 300; ++i)
+	{
+		parity += " + x" + std::to_string (i);
+		reversed += " + x" + std::to_string (301 - i);
+	}
+
+	BooleanExpression wide (parity);
+	EXPECT_THROW (wide.table (), const char*);
+	EXPECT_TRUE (wide.classification ().linear);
+	EXPECT_FALSE (wide.classification ().self_dual);
+	EXPECT_TRUE (wide.is_satisfiable ());
+	EXPECT_TRUE (wide.equivalent (BooleanExpression (reversed)));
+	EXPECT_FALSE (wide.equivalent (BooleanExpression (reversed + " + x301")));
 }
 
 TEST (Assignments, assignment_operator)
@@ -290,6 +400,183 @@ TEST (Table, brackets)
 	EXPECT_EQ (a.table (), "01010101010101010101010101010111");
 }
 
+TEST (Table, packed_truth_table)
+{
+	BooleanExpression a ("x1 & x2 & x3 & x4 & x5 & x6 & x7 & x8");
+	TruthTable t = a.truth_table ();
+
+	EXPECT_EQ (t.vars (), 8);
+	EXPECT_EQ (t.words (), 4);
+	EXPECT_EQ (t.data ()[0], 0);
+	EXPECT_EQ (t.data ()[3], 1ULL << 63);
+
+	a = ("x1 + x2 + x3 + x4 + x5 + x6 + x7");
+	std::string tab = a.table ();
+	ASSERT_EQ (tab.size (), 128);
+	for (size_t i = 0; i < tab.size (); ++i)
+	{
+		EXPECT_EQ (tab[i], (std::popcount (i) & 1) ? '1' : '0');
+	}
+
+	a = ("~x1 & x2 v x3");
+	t = a.truth_table ();
+	EXPECT_EQ (t.data ()[0], 0xAEULL);
+}
+
+TEST (Table, binary_records)
+{
+	std::string r = BooleanExpression ("x2 & x10").packed_table ();
+	const unsigned char expected[] = {
+		2, 0, 0, 0, 2, 0, 0, 0, 10, 0, 0, 0, 0, 0, 0, 0,
+		8, 0, 0, 0, 0, 0, 0, 0
+	};
+	ASSERT_EQ (r.size (), sizeof (expected));
+	EXPECT_EQ (memcmp (r.data (), expected, sizeof (expected)), 0);
+
+	// Нечётное число переменных - без выравнивающих байтов, таблица из двух слов.
+	BooleanExpression f ("x1 & x2 & x3 & x4 & x5 & x6 & x7");
+	r = f.packed_table ();
+	ASSERT_EQ (r.size (), 32u + 16u);
+	EXPECT_EQ (static_cast<unsigned char> (r[0]), 7);
+	EXPECT_EQ (static_cast<unsigned char> (r[28]), 7);
+	EXPECT_EQ (static_cast<unsigned char> (r[47]), 0x80);
+	EXPECT_EQ (r.substr (32, 15), std::string (15, '\0'));
+
+	r = BooleanExpression ("1").packed_table ();
+	EXPECT_EQ (r, std::string ("\0\0\0\0\0\0\0\0\1\0\0\0\0\0\0\0", 16));
+}
+
+TEST (Table, streamed_chunks)
+{
+	for (int vars : { 0, 3, 6, 16, 20 })
+	{
+		std::string text = "1";
+		for (int i = 1; i <= vars; ++i)
+		{
+			text += (i % 3 == 0) ? " + x" : (i % 3 == 1) ? " & x" : " v x";
+			text += std::to_string (i);
+		}
+		BooleanExpression f (text);
+
+		std::string joined;
+		size_t chunks = 0;
+		f.write_table ([&] (std::string_view chunk) {
+			EXPECT_LE (chunk.size (), BooleanExpression::ChunkRows);
+			joined += chunk;
+			++chunks;
+		});
+
+		EXPECT_EQ (joined, f.table ()) << vars;
+		EXPECT_EQ (chunks, (joined.size () + BooleanExpression::ChunkRows - 1) / BooleanExpression::ChunkRows);
+	}
+
+	TruthTable t (7);
+	t.data ()[0] = 0x8000000000000001ULL;
+	t.data ()[1] = 0x00000000000000F0ULL;
+	std::string s = t.to_string ();
+	EXPECT_EQ (s, "1" + std::string (62, '0') + "1" + "00001111" + std::string (56, '0'));
+}
+
+TEST (Table, all_instruction_sets)
+{
+	BooleanExpression a ("(x1 & x2 v ~x3) + (x4 > x5) = (x6 | x7) ^ (x8 < x9)");
+	BitIsa saved = bit_isa ();
+	bit_set_isa (BitIsa::Scalar);
+	std::string expected = a.table ();
+
+	for (BitIsa isa : { BitIsa::Avx2, BitIsa::Avx512 })
+	{
+		if (bit_isa_supported (isa))
+		{
+			bit_set_isa (isa);
+			EXPECT_EQ (a.table (), expected) << bit_isa_name (isa);
+		}
+	}
+
+	bit_set_isa (saved);
+}
+
+TEST (Table, parallel_rows)
+{
+	BooleanExpression a ("(x1 & x2 v ~x3) + (x4 > x5) = (x6 | x7) ^ (x8 < x9)");
+	TruthTable expected = a.truth_table ();
+
+	for (size_t threads : { 2, 3, 8, 100 })
+	{
+		EXPECT_TRUE (a.truth_table (threads) == expected) << threads;
+	}
+
+	a = ("x1 & x2");
+	EXPECT_EQ (a.truth_table (4).to_string (), "0001");
+}
+
+TEST (Table, program)
+{
+	// x1 > ~x2
+	Program p;
+	p.emit (OpCode::Var, 0);
+	p.emit (OpCode::Var, 1);
+	p.emit (OpCode::Neg);
+	p.emit (OpCode::Impl);
+
+	EXPECT_TRUE (p.complete ());
+	EXPECT_EQ (p.size (), 4);
+	EXPECT_EQ (p.depth (), 2);
+
+	BitWorkspace bits (2);
+	bits.block (0, 1);
+
+	uint64_t word = 0;
+	p.calc (&word, bits);
+	EXPECT_EQ (word & 0xF, 0x7);
+
+	EXPECT_THROW (p.emit (OpCode::Conj), const char*);
+}
+
+TEST (Table, shared_subexpressions)
+{
+	BooleanExpression f ("(x1 & x2) > ((x1 & x2) = x3)");
+	EXPECT_EQ (f.node_count (), 6);
+	EXPECT_EQ (f.table (), "11111101");
+
+	std::string str = "x1 & x2 v x3";
+	for (int i = 0; i < 49; ++i)
+	{
+		str += " & (x1 & x2 v x3)";
+	}
+
+	BooleanExpression g (str);
+	EXPECT_LT (g.node_count (), 60);
+	EXPECT_EQ (g.table (), BooleanExpression ("x1 & x2 v x3").table ());
+	EXPECT_EQ (BooleanExpression (g).table (), g.table ());
+}
+
+TEST (Table, simplification)
+{
+	BooleanExpression zero ("x1 & 0");
+	EXPECT_EQ (zero.node_count (), 1);
+	EXPECT_EQ (zero.removed_nodes (), 1);
+	EXPECT_EQ (zero.table (), "00");
+
+	BooleanExpression neg ("~~x2");
+	EXPECT_EQ (neg.node_count (), 1);
+	EXPECT_EQ (neg.removed_nodes (), 1);
+	EXPECT_EQ (neg.table (), "01");
+
+	EXPECT_EQ (BooleanExpression ("x3 + x3").node_count (), 1);
+	EXPECT_EQ (BooleanExpression ("1 > x4").node_count (), 1);
+	EXPECT_EQ (BooleanExpression ("x1 & (x1 v x2)").node_count (), 1);
+	EXPECT_EQ (BooleanExpression ("x1 + (x2 + x1)").node_count (), 1);
+	EXPECT_EQ (BooleanExpression ("x1 v ~x1").table (), "11");
+	EXPECT_EQ (BooleanExpression ("x1 | x1").table (), "10");
+	EXPECT_EQ (BooleanExpression ("x1 & x2 v x3").removed_nodes (), 0);
+
+	// после упрощения таблица та же, что у выражения без лишних узлов.
+	BooleanExpression f ("((x1 + 1) > (x2 & (x2 v x3))) = ~~(x3 v 0)");
+	EXPECT_EQ (f.table (), BooleanExpression ("(~x1 > x2) = x3").table ());
+	EXPECT_GT (f.removed_nodes (), 0);
+}
+
 TEST (Zhegalkin, all_basic_operations)
 {
 	BooleanExpression unit ("1");
@@ -404,6 +691,70 @@ x1 & x3 & x4 + x1 & x3 & x4 & x5 + x1 & x2 + x1 & x2 & x5 + x1 & x2 & x3 + x1 &
 	EXPECT_EQ (std::string (a.zhegalkin ()), "1 + x3 & x4 + x3 & x4 & x5 + x2 & x3 & x4 + x2 & x3 & x4 & x5 + x1 & x2 & x3 & x4 + x1 & x2 & x3 & x4 & x5");
 }
 
+TEST (Zhegalkin, wide_functions)
+{
+	BooleanExpression a ("x1 & x2 & x3 & x4 & x5 & x6 & x7 & x8");
+	EXPECT_EQ (std::string (a.zhegalkin ()), "x1 & x2 & x3 & x4 & x5 & x6 & x7 & x8");
+
+	a = ("x1 v x8");
+	EXPECT_EQ (std::string (a.zhegalkin ()), "x8 + x1 + x1 & x8");
+
+	a = ("x9 = x1 & x5 v ~x7");
+	EXPECT_EQ (std::string (a.zhegalkin ()), "x9 + x7 + x1 & x5 & x7");
+
+	a = ("(x1 & x2 v ~x3) + (x4 > x5) = (x6 | x7) ^ (x8 < x9)");
+	TruthTable t = a.truth_table ();
+	TruthTable coef = t;
+	coef.mobius ();
+	EXPECT_FALSE (coef == t);
+	coef.mobius ();
+	EXPECT_TRUE (coef == t);
+}
+
+TEST (Zhegalkin, polynomial_object)
+{
+	AnfPolynomial p = BooleanExpression ("x2 > x5").zhegalkin ();
+	EXPECT_EQ (p.vars (), std::vector<unsigned> ({ 2, 5 }));
+	EXPECT_EQ (p.monomials (), std::vector<uint64_t> ({ 0, 1, 3 }));
+	EXPECT_EQ (p.size (), 3);
+	EXPECT_EQ (p.degree (), 2);
+	EXPECT_FALSE (p.is_linear ());
+
+	p = BooleanExpression ("x1 = x3").zhegalkin ();
+	EXPECT_EQ (p.degree (), 1);
+	EXPECT_TRUE (p.is_linear ());
+
+	p = BooleanExpression ("x1 & ~x1").zhegalkin ();
+	EXPECT_EQ (p.size (), 0);
+	EXPECT_EQ (p.degree (), 0);
+	EXPECT_EQ (std::string (p), "0");
+}
+
+TEST (Monotone, basic_functions)
+{
+	EXPECT_TRUE (BooleanExpression ("0").truth_table ().is_monotone ());
+	EXPECT_TRUE (BooleanExpression ("x1 & x2").truth_table ().is_monotone ());
+	EXPECT_TRUE (BooleanExpression ("x1 v x2 & x3").truth_table ().is_monotone ());
+	EXPECT_FALSE (BooleanExpression ("~x1").truth_table ().is_monotone ());
+	EXPECT_FALSE (BooleanExpression ("x1 + x2").truth_table ().is_monotone ());
+	EXPECT_FALSE (BooleanExpression ("x1 > x2").truth_table ().is_monotone ());
+
+	EXPECT_TRUE (check_mono ("0001", 0, 4));
+	EXPECT_FALSE (check_mono ("0110", 0, 4));
+	EXPECT_TRUE (check_mono ("10000111", 4, 4));
+	EXPECT_TRUE (check_mono ("", 0, 0));
+	EXPECT_TRUE (check_mono ("1", 0, 1));
+	EXPECT_THROW (check_mono ("011", 0, 3), const char*);
+}
+
+TEST (Monotone, wide_functions)
+{
+	EXPECT_TRUE (BooleanExpression ("x1 & x2 v x3 & x4 v x5 & x6 v x7 & x8 v x9").truth_table ().is_monotone ());
+	EXPECT_FALSE (BooleanExpression ("x1 & x2 v x3 & x4 v x5 & x6 v x7 & x8 v ~x9").truth_table ().is_monotone ());
+	EXPECT_FALSE (BooleanExpression ("~x1 & x2 & x3 & x4 & x5 & x6 & x7 & x8 & x9").truth_table ().is_monotone ());
+	EXPECT_FALSE (BooleanExpression ("x1 & x2 & x3 & x4 & x5 & x6 & ~x7").truth_table ().is_monotone ());
+}
+
 TEST (IsFullSystem, true_min_full_system)
 {
 	std::vector<BooleanExpression> system = { BooleanExpression ("x1 | x2") };
@@ -540,4 +891,359 @@ TEST (IsFullSystem, false_compound_full_system)
 
 	system = { BooleanExpression ("x9 + x2"), BooleanExpression ("x1 + x2 + x3"), BooleanExpression ("x1 & x2") };
 	EXPECT_FALSE (isFullSystem (system));
-}
\ No newline at end of file
+}
+
+TEST (IsFullSystem, classification)
+{
+	PostClassification c = BooleanExpression ("x1 = x2").classification ();
+	EXPECT_FALSE (c.zero_save);
+	EXPECT_TRUE (c.unit_save);
+	EXPECT_FALSE (c.self_dual);
+	EXPECT_FALSE (c.monotone);
+	EXPECT_TRUE (c.linear);
+
+	c = BooleanExpression ("x1 & x2 v x2 & x3 v x3 & x1").classification ();
+	EXPECT_TRUE (c.zero_save && c.unit_save && c.self_dual && c.monotone);
+	EXPECT_FALSE (c.linear);
+
+	// константы не самодвойственны.
+	EXPECT_FALSE (BooleanExpression ("1").classification ().self_dual);
+	EXPECT_TRUE (BooleanExpression ("~x1").classification ().self_dual);
+	EXPECT_TRUE (BooleanExpression ("x1 + x2 + x3 + x4 + x5 + x6 + x7 + x8 + x9").classification ().self_dual);
+	EXPECT_FALSE (BooleanExpression ("x1 + x2 + x3 + x4 + x5 + x6 + x7 + x8").classification ().self_dual);
+	// 6 переменных - ровно одно слово таблицы.
+	EXPECT_FALSE (BooleanExpression ("x1 + x2 + x3 + x4 + x5 + x6").classification ().self_dual);
+	EXPECT_FALSE (BooleanExpression ("x1 & x2 & x3 & x4 & x5 & x6").classification ().self_dual);
+	EXPECT_TRUE (BooleanExpression ("x1 & (x2 + x3 + x4) v (x2 + x3 + x4) & (x5 + x6 + x2) v (x5 + x6 + x2) & x1").classification ().self_dual);
+
+	std::vector<BooleanExpression> system = { BooleanExpression ("x1 & x2"), BooleanExpression ("x1 v x2") };
+	c = classify (system);
+	EXPECT_TRUE (c.zero_save && c.unit_save && c.monotone);
+	EXPECT_FALSE (c.self_dual || c.linear || c.is_complete ());
+
+	system.push_back (BooleanExpression ("~x1"));
+	EXPECT_TRUE (classify (system).is_complete ());
+}
+
+TEST (IsFullSystem, six_variable_function)
+{
+	// Только первая функция не самодвойственна.
+	std::vector<BooleanExpression> system = {
+		BooleanExpression ("(~(x9 < (~x3 > (x5 < x7))) & (~x6 & x2))"),
+		BooleanExpression ("~x7"),
+		BooleanExpression ("~x8"),
+		BooleanExpression ("~~((x1 > x1) = (x3 = 0))")
+	};
+
+	EXPECT_TRUE (isFullSystem (system));
+}
+
+TEST (Bdd, matches_truth_table)
+{
+	const char* exprs[] = {
+		"0", "1", "x1", "~x2", "x1 = x2", "x1 + x2 + x3",
+		"x1 & x2 v x2 & x3 v x3 & x1",
+		"(x1 & x2 v ~x3) + (x4 > x5) = (x6 | x7) ^ (x8 < x9)",
+		"x1 & x2 v x3 & x4 v x5 & x6 v x7 & x8 v x9"
+	};
+
+	BddManager manager;
+	for (const char* str : exprs)
+	{
+		BooleanExpression f (str);
+		BddRef node = f.bdd (manager);
+		PostClassification c = f.classification ();
+
+		EXPECT_EQ (manager.zero_save (node), c.zero_save) << str;
+		EXPECT_EQ (manager.unit_save (node), c.unit_save) << str;
+		EXPECT_EQ (manager.is_self_dual (node), c.self_dual) << str;
+		EXPECT_EQ (manager.is_monotone (node), c.monotone) << str;
+		EXPECT_EQ (manager.is_linear (node), c.linear) << str;
+		EXPECT_EQ (manager.is_satisfiable (node), f.is_satisfiable ()) << str;
+	}
+
+	EXPECT_EQ (BooleanExpression ("x1 & x2").bdd (manager), BooleanExpression ("x2 & x1").bdd (manager));
+	EXPECT_EQ (BooleanExpression ("x1 > x2").bdd (manager), BooleanExpression ("~x1 v x2").bdd (manager));
+	EXPECT_NE (BooleanExpression ("x1 > x2").bdd (manager), BooleanExpression ("x1 < x2").bdd (manager));
+	EXPECT_FALSE (BooleanExpression ("x3 & ~x3").is_satisfiable ());
+}
+
+TEST (Equivalent, semantic_comparison)
+{
+	EXPECT_TRUE (BooleanExpression ("x1 & x2").equivalent (BooleanExpression ("x2 & x1")));
+	EXPECT_FALSE (BooleanExpression ("x1 & x2") == BooleanExpression ("x2 & x1"));
+	EXPECT_TRUE (BooleanExpression ("~(x1 v x2)").equivalent (BooleanExpression ("~x1 & ~x2")));
+	EXPECT_TRUE (BooleanExpression ("x1 ^ x2").equivalent (BooleanExpression ("~x2 & ~x1")));
+	EXPECT_TRUE (BooleanExpression ("x1 > x2").equivalent (BooleanExpression ("x2 < x1")));
+	EXPECT_FALSE (BooleanExpression ("x1 > x2").equivalent (BooleanExpression ("x1 < x2")));
+
+	// разные множества переменных
+	EXPECT_TRUE (BooleanExpression ("x1 & (x2 v ~x2)").equivalent (BooleanExpression ("x1")));
+	EXPECT_TRUE (BooleanExpression ("x5 + x5").equivalent (BooleanExpression ("0")));
+	EXPECT_FALSE (BooleanExpression ("x1").equivalent (BooleanExpression ("x2")));
+	EXPECT_FALSE (BooleanExpression ("x1 & x2 & x3 & x4 & x5 & x6 & x7 & x8 & x9").equivalent (BooleanExpression ("0")));
+
+	BooleanExpression f ("(x1 & x2 v ~x3) + (x4 > x5) = (x6 | x7) ^ (x8 < x9)");
+	BooleanExpression g ("(x8 < x9) ^ (x7 | x6) = (x5 < x4) + (~x3 v x2 & x1)");
+	EXPECT_EQ (f.fingerprint (), g.fingerprint ());
+	EXPECT_TRUE (f.equivalent (g));
+	EXPECT_NE (f.fingerprint (), BooleanExpression ("x1 & x2").fingerprint ());
+}
+
+TEST (Equivalent, concurrent_caches)
+{
+	const BooleanExpression f ("x1 & x2 v x3 + x4 > x5");
+	BooleanExpression copy = f;
+	std::vector<std::thread> pool;
+	std::vector<uint64_t> prints (8);
+
+	for (size_t i = 0; i < prints.size (); ++i)
+	{
+		pool.emplace_back ([&, i] {
+			const BooleanExpression& g = (i % 2) ? f : copy;
+			prints[i] = g.fingerprint ();
+			EXPECT_FALSE (g.classification ().monotone);
+		});
+	}
+	for (std::thread& t : pool)
+	{
+		t.join ();
+	}
+
+	for (uint64_t p : prints)
+	{
+		EXPECT_EQ (p, prints[0]);
+	}
+	EXPECT_EQ (&f.classification (), &copy.classification ());
+}
+
+TEST (Bdd, wide_functions)
+{
+	const uint32_t count = 128;
+	BddManager manager;
+
+	BddRef parity = manager.constant (false);
+	BddRef majority = manager.constant (false); // x0 & x1 v x1 & x2 v x0 & x2
+	BddRef chain = manager.constant (true);
+	for (uint32_t i = 0; i < count; ++i)
+	{
+		parity = manager.apply (BitOp::Add, parity, manager.var (i));
+		chain = manager.apply (BitOp::Conj, chain, manager.apply (BitOp::Dis, manager.var (2 * i), manager.var (2 * i + 1)));
+	}
+	for (uint32_t i = 0; i < 3; ++i)
+	{
+		BddRef pair = manager.apply (BitOp::Conj, manager.var (i), manager.var ((i + 1) % 3));
+		majority = manager.apply (BitOp::Dis, majority, pair);
+	}
+
+	EXPECT_TRUE (manager.is_linear (parity));
+	EXPECT_FALSE (manager.is_self_dual (parity)); // чётное число слагаемых.
+	EXPECT_TRUE (manager.is_self_dual (manager.apply (BitOp::Add, parity, manager.var (count))));
+	EXPECT_FALSE (manager.is_monotone (parity));
+	EXPECT_TRUE (manager.zero_save (parity));
+	EXPECT_FALSE (manager.unit_save (parity));
+
+	EXPECT_TRUE (manager.is_monotone (chain));
+	EXPECT_FALSE (manager.is_linear (chain));
+
+	EXPECT_TRUE (manager.is_self_dual (majority));
+	EXPECT_TRUE (manager.is_satisfiable (manager.apply (BitOp::Conj, chain, parity)));
+	EXPECT_FALSE (manager.is_satisfiable (manager.apply (BitOp::Add, chain, manager.flip (manager.flip (chain)))));
+}
+
+template <typename Pool>
+void check_avl_tree ()
+{
+	AVLTree<int, Pool> tree;
+	const int count = 10000;
+
+	for (int i = 0; i < count; ++i)
+	{
+		tree.insert ((i * 7919) % count);
+	}
+
+	EXPECT_EQ (tree.size (), count);
+	EXPECT_GE (tree.height (), 14);
+	EXPECT_LE (tree.height (), 20);
+
+	for (int i = 0; i < count; i += 2)
+	{
+		tree.erase (tree.find (i));
+	}
+
+	EXPECT_TRUE (tree.find (0) == tree.end ());
+	EXPECT_FALSE (tree.find (1) == tree.end ());
+
+	int expected = 1;
+	for (auto pos = tree.begin (); pos != tree.end (); ++pos)
+	{
+		EXPECT_EQ (*pos, expected);
+		expected += 2;
+	}
+
+	tree.clear ();
+	EXPECT_EQ (tree.size (), 0);
+	EXPECT_EQ (tree.height (), 0);
+	EXPECT_TRUE (tree.begin () == tree.end ());
+
+	tree.insert (1);
+	EXPECT_EQ (tree.height (), 1);
+}
+
+TEST (AVLTree, heap_pool)
+{
+	check_avl_tree<HeapPool> ();
+}
+
+TEST (AVLTree, slab_pool)
+{
+	check_avl_tree<SlabPool> ();
+}
+
+TEST (AVLTree, clear_deep_tree)
+{
+	AVLTree<std::string> tree;
+	for (int i = 0; i < 100000; ++i)
+	{
+		tree.insert (std::to_string (i));
+	}
+
+	tree.clear ();
+	EXPECT_EQ (tree.size (), 0);
+}
+
+TEST (LineReader, long_lines)
+{
+	std::string path = testing::TempDir () + "boolcalc_lines.txt";
+	std::string wide = "x1";
+	for (int i = 0; i < 2000; ++i)
+	{
+		wide += " & x2";
+	}
+
+	FILE* file = fopen (path.c_str (), "wb");
+	ASSERT_NE (file, nullptr);
+	fprintf (file, "x1 v x2\n%s\n\nx3", wide.c_str ());
+	fclose (file);
+
+	LineReader reader (path.c_str ());
+	ASSERT_TRUE (reader.is_open ());
+
+	std::string_view line;
+	ASSERT_TRUE (reader.next (line));
+	EXPECT_EQ (line, "x1 v x2");
+	ASSERT_TRUE (reader.next (line));
+	EXPECT_EQ (line, wide);
+	EXPECT_EQ (BooleanExpression (line).table (), "0001");
+	ASSERT_TRUE (reader.next (line));
+	EXPECT_EQ (line, "");
+	ASSERT_TRUE (reader.next (line));
+	EXPECT_EQ (line, "x3");
+	EXPECT_FALSE (reader.next (line));
+
+	remove (path.c_str ());
+	EXPECT_FALSE (LineReader (path.c_str ()).is_open ());
+}
+
+std::string table_line (std::string_view str)
+{
+	return BooleanExpression (str).table ();
+}
+
+TEST (Batch, keeps_input_order)
+{
+	std::string path = testing::TempDir () + "boolcalc_batch.txt";
+	std::string expected;
+
+	FILE* file = fopen (path.c_str (), "wb");
+	ASSERT_NE (file, nullptr);
+	for (int i = 0; i < 5000; ++i)
+	{
+		const char* line = (i % 3 == 0) ? "x1 & x2" : (i % 3 == 1) ? "x1 v x2 v x3" : "~x1";
+		fprintf (file, "%s\n", line);
+		expected += BooleanExpression (line).table () + "\n";
+	}
+	fclose (file);
+
+	for (size_t threads : { 1, 2, 8 })
+	{
+		LineReader reader (path.c_str ());
+		std::ostringstream out;
+		process_lines (reader, out, table_line, threads);
+		EXPECT_EQ (out.str (), expected) << threads;
+	}
+
+	file = fopen (path.c_str (), "ab");
+	fprintf (file, "x1 & & x2\n");
+	fclose (file);
+
+	LineReader reader (path.c_str ());
+	std::ostringstream out;
+	EXPECT_THROW (process_lines (reader, out, table_line, 4), const char*);
+
+	remove (path.c_str ());
+}
+
+TEST (Corpus, reproducible_and_valid)
+{
+	CorpusOptions options;
+	options.vars = 5;
+	options.depth = 6;
+	options.sharing = 0.3;
+	options.seed = 42;
+
+	CorpusGenerator a (options), b (options);
+	std::string ops;
+	for (int i = 0; i < 500; ++i)
+	{
+		std::string x, y;
+		a.line (x);
+		b.line (y);
+		ASSERT_EQ (x, y);
+
+		BooleanExpression f (x);
+		for (char ch : std::string (f))
+		{
+			if (strchr ("~&v+><=|^", ch) != nullptr && ops.find (ch) == std::string::npos)
+			{
+				ops += ch;
+			}
+		}
+		EXPECT_LE (f.table ().size (), 32u);
+	}
+	EXPECT_EQ (ops.size (), 9u);
+
+	options.seed = 43;
+	CorpusGenerator c (options);
+	std::string x, z;
+	CorpusGenerator (CorpusOptions {5, 6, 0.3, 42}).line (x);
+	c.line (z);
+	EXPECT_NE (x, z);
+}
+
+TEST (Stats, counts_phases)
+{
+	reset_stats ();
+	BooleanExpression f ("x1 & x2 v x1 & x2 v x3");
+	f.table ();
+	f.zhegalkin ();
+	Stats s = stats ();
+
+	if (!StatsEnabled)
+	{
+		EXPECT_EQ (s[Counter::Expressions], 0u);
+		EXPECT_EQ (s.calls[size_t (Phase::Parse)], 0u);
+		return;
+	}
+
+	EXPECT_EQ (s[Counter::Expressions], 1u);
+	EXPECT_EQ (s[Counter::Vars], 3u);
+	EXPECT_EQ (s[Counter::Rows], 16u);
+	EXPECT_GT (s[Counter::RemovedNodes], 0u);
+	// Кроме блоков Arena и таблиц - строки, векторы и сам разобранный объект.
+	EXPECT_GT (s[Counter::Allocations], 5u);
+	EXPECT_EQ (s.calls[size_t (Phase::Parse)], 1u);
+	EXPECT_EQ (s.calls[size_t (Phase::Table)], 2u);
+	EXPECT_EQ (s.calls[size_t (Phase::Zhegalkin)], 1u);
+	EXPECT_EQ (s.calls[size_t (Phase::Classify)], 0u);
+}
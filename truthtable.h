@@ -0,0 +1,233 @@
+#ifndef TruthTable_
+#define TruthTable_
+
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// Значения младших разрядов номера строки внутри 64-битного слова.
+const uint64_t RowPatterns[6] = {
+	0xAAAAAAAAAAAAAAAAULL,
+	0xCCCCCCCCCCCCCCCCULL,
+	0xF0F0F0F0F0F0F0F0ULL,
+	0xFF00FF00FF00FF00ULL,
+	0xFFFF0000FFFF0000ULL,
+	0xFFFFFFFF00000000ULL
+};
+
+// Таблица истинности, упакованная по 64 строки в слове.
+// Строка i хранится в разряде (i & 63) слова (i >> 6).
+class TruthTable
+{
+	size_t vars_; // количество переменных.
+	std::vector<uint64_t> words_;
+
+public:
+	static constexpr size_t MaxVars = 32;
+
+	TruthTable (size_t vars = 0) : vars_ (vars), words_ (word_count (vars), 0)
+	{}
+
+	static size_t word_count (size_t vars)
+	{
+		return (vars < 6) ? 1 : (size_t (1) << (vars - 6));
+	}
+
+	size_t vars () const
+	{
+		return vars_;
+	}
+	unsigned long long rows () const
+	{
+		return 1ULL << vars_;
+	}
+	size_t words () const
+	{
+		return words_.size ();
+	}
+
+	uint64_t* data ()
+	{
+		return words_.data ();
+	}
+	const uint64_t* data () const
+	{
+		return words_.data ();
+	}
+
+	// маска значимых разрядов последнего слова.
+	uint64_t tail_mask () const
+	{
+		return (vars_ < 6) ? (~0ULL >> (64 - rows ())) : ~0ULL;
+	}
+
+	bool get (unsigned long long row) const
+	{
+		return (words_[row >> 6] >> (row & 63)) & 1;
+	}
+	void set (unsigned long long row, bool x)
+	{
+		uint64_t bit = 1ULL << (row & 63);
+		if (x)
+		{
+			words_[row >> 6] |= bit;
+		} else
+		{
+			words_[row >> 6] &= ~bit;
+		}
+	}
+
+	// Преобразование Мёбиуса на месте: значения функции переходят в
+	// коэффициенты полинома Жегалкина (и обратно). Разряд m результата -
+	// коэффициент при конъюнкции переменных, соответствующих единицам m.
+	void mobius ()
+	{
+		size_t count = words_.size ();
+		size_t low = (vars_ < 6) ? vars_ : 6;
+
+		for (size_t k = 0; k < low; ++k)
+		{
+			size_t step = size_t (1) << k;
+			for (size_t j = 0; j < count; ++j)
+			{
+				words_[j] ^= (words_[j] << step) & RowPatterns[k];
+			}
+		}
+
+		for (size_t step = 1; step < count; step <<= 1)
+		{
+			for (size_t j = 0; j < count; ++j)
+			{
+				if ((j & step) != 0)
+				{
+					words_[j] ^= words_[j ^ step];
+				}
+			}
+		}
+	}
+
+	// Функция монотонна, если для каждой переменной значения при 0
+	// не превосходят значений при 1 (остальные переменные те же).
+	bool is_monotone () const
+	{
+		size_t count = words_.size ();
+		size_t low = (vars_ < 6) ? vars_ : 6;
+
+		for (size_t k = 0; k < low; ++k)
+		{
+			size_t step = size_t (1) << k;
+			for (size_t j = 0; j < count; ++j)
+			{
+				uint64_t lower = words_[j] & ~RowPatterns[k];
+				uint64_t upper = (words_[j] & RowPatterns[k]) >> step;
+				if ((lower & ~upper) != 0)
+				{
+					return false;
+				}
+			}
+		}
+
+		for (size_t step = 1; step < count; step <<= 1)
+		{
+			for (size_t j = 0; j < count; ++j)
+			{
+				if ((j & step) == 0 && (words_[j] & ~words_[j | step]) != 0)
+				{
+					return false;
+				}
+			}
+		}
+
+		return true;
+	}
+
+	// Функция самодвойственна, если на противоположных наборах
+	// принимает противоположные значения: f(~x) = ~f(x).
+	bool is_self_dual () const
+	{
+		if (vars_ == 0)
+		{
+			return false;
+		}
+
+		size_t count = words_.size ();
+		if (vars_ <= 6)
+		{
+			uint64_t reversed = reverse_bits (words_[0]) >> (64 - rows ());
+			return (words_[0] ^ reversed) == tail_mask ();
+		}
+
+		// Набор ~x лежит в слове count - 1 - j в обратном порядке разрядов.
+		for (size_t j = 0; j < count / 2; ++j)
+		{
+			if ((words_[j] ^ reverse_bits (words_[count - 1 - j])) != ~0ULL)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+
+	static uint64_t reverse_bits (uint64_t x)
+	{
+		x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+		x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+		x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+		x = ((x >> 8) & 0x00FF00FF00FF00FFULL) | ((x & 0x00FF00FF00FF00FFULL) << 8);
+		x = ((x >> 16) & 0x0000FFFF0000FFFFULL) | ((x & 0x0000FFFF0000FFFFULL) << 16);
+		return (x >> 32) | (x << 32);
+	}
+
+	bool operator==(const TruthTable& other) const
+	{
+		return vars_ == other.vars_ && words_ == other.words_;
+	}
+
+	// Записывает 64 * count строк из words символами '0' и '1' в out.
+	// Каждый байт слова разворачивается в 8 символов без ветвлений.
+	static void to_chars (const uint64_t* words, size_t count, char* out)
+	{
+		for (size_t j = 0; j < count; ++j)
+		{
+			uint64_t word = words[j];
+			for (int k = 0; k < 8; ++k, out += 8)
+			{
+				// Разряд i байта попадает в байт i, затем в его младший разряд.
+				uint64_t x = ((word >> (8 * k)) & 0xFF) * 0x0101010101010101ULL;
+				x &= 0x8040201008040201ULL;
+				x = ((x + 0x7F7F7F7F7F7F7F7FULL) >> 7) & 0x0101010101010101ULL;
+				x |= 0x3030303030303030ULL;
+
+				if constexpr (std::endian::native == std::endian::little)
+				{
+					memcpy (out, &x, 8);
+				} else
+				{
+					for (int i = 0; i < 8; ++i)
+					{
+						out[i] = static_cast<char> (x >> (8 * i));
+					}
+				}
+			}
+		}
+	}
+
+	std::string to_string () const
+	{
+		if (vars_ < 6)
+		{
+			char row[64];
+			to_chars (words_.data (), 1, row);
+			return std::string (row, rows ());
+		}
+
+		std::string result (rows (), '0');
+		to_chars (words_.data (), words_.size (), result.data ());
+		return result;
+	}
+};
+
+#endif // TruthTable_
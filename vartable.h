@@ -0,0 +1,126 @@
+#ifndef VarTable_
+#define VarTable_
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Переменная во внутренней записи выражения занимает VarTokenSize байт
+// со старшим разрядом 1, по 7 разрядов номера в байте, младшие первыми.
+// Такие байты не совпадают ни с символами операций, ни с '\0'.
+const size_t VarTokenSize = 5;
+
+inline bool is_var_token (unsigned char ch)
+{
+	return ch >= 128;
+}
+inline void write_var (char* out, uint32_t id)
+{
+	for (size_t i = 0; i < VarTokenSize; ++i)
+	{
+		out[i] = static_cast<char> (0x80 | ((id >> (7 * i)) & 0x7F));
+	}
+}
+inline uint32_t read_var (const char* in)
+{
+	uint32_t id = 0;
+	for (size_t i = 0; i < VarTokenSize; ++i)
+	{
+		id |= uint32_t (static_cast<unsigned char> (in[i]) & 0x7F) << (7 * i);
+	}
+	return id;
+}
+
+// Таблица переменных: номер N переменной xN -> плотный номер 0, 1, ...
+// в порядке первого появления. Номера ищутся в хеш-таблице с открытой
+// адресацией; в ячейке хранится плотный номер + 1, 0 - пустая ячейка.
+class VarTable
+{
+	std::vector<uint32_t> names_; // names_[id] - номер переменной.
+	std::vector<uint32_t> table_;
+
+	static constexpr size_t InitialSize = 16;
+
+	static size_t hash (uint32_t name)
+	{
+		return (name * 0x9E3779B97F4A7C15ULL) >> 32;
+	}
+
+	size_t find (uint32_t name) const
+	{
+		size_t mask = table_.size () - 1;
+		size_t i = hash (name) & mask;
+		while (table_[i] != 0 && names_[table_[i] - 1] != name)
+		{
+			i = (i + 1) & mask;
+		}
+		return i;
+	}
+
+	void rehash (size_t size)
+	{
+		table_.assign (size, 0);
+		for (uint32_t id = 0; id < names_.size (); ++id)
+		{
+			table_[find (names_[id])] = id + 1;
+		}
+	}
+
+public:
+	VarTable () : table_ (InitialSize, 0)
+	{}
+
+	uint32_t intern (uint32_t name)
+	{
+		size_t i = find (name);
+		if (table_[i] != 0)
+		{
+			return table_[i] - 1;
+		}
+
+		names_.push_back (name);
+		table_[i] = names_.size ();
+		if (2 * names_.size () > table_.size ())
+		{
+			rehash (2 * table_.size ());
+		}
+
+		return names_.size () - 1;
+	}
+
+	size_t size () const
+	{
+		return names_.size ();
+	}
+	const std::vector<uint32_t>& names () const
+	{
+		return names_;
+	}
+
+	// Перенумеровывает переменные по возрастанию номеров.
+	// Возвращает новые плотные номера по старым.
+	std::vector<uint32_t> sort ()
+	{
+		std::vector<uint32_t> order (names_.size ());
+		for (uint32_t id = 0; id < order.size (); ++id)
+		{
+			order[id] = id;
+		}
+		std::sort (order.begin (), order.end (), [this] (uint32_t a, uint32_t b) { return names_[a] < names_[b]; });
+
+		std::vector<uint32_t> renumber (names_.size ());
+		std::vector<uint32_t> names (names_.size ());
+		for (uint32_t id = 0; id < order.size (); ++id)
+		{
+			renumber[order[id]] = id;
+			names[id] = names_[order[id]];
+		}
+
+		names_ = std::move (names);
+		rehash (table_.size ());
+		return renumber;
+	}
+};
+
+#endif // VarTable_